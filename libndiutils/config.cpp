@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndiutils.h"
+
+// These configuration settings can also be done using a file
+// See "Configuration Files" in the SDK documentation for details
+
+std::string make_send_config(const char* machinename, const std::string& bitrate, const std::string& shqmode,
+	const char* transport, const char* adapters)
+{
+	// Opening stanza
+	std::string ndi_config;
+	ndi_config = R"({ "ndi": {)";
+
+	// Without a valid vendor ID, the Embedded NDI stack runs in demo mode for 30 minutes
+	// If you have a valid vendor ID, add it below, eg:
+	// ndi_config.append( R"( "vendor": { "name": "My Company", "id": "00000000000000000000000000000000000000000000", } )";
+
+	// If machinename is specified, add it to our JSON config
+	if (machinename) {
+		ndi_config.append( R"( "machinename": ")" );
+		ndi_config.append( machinename );
+		ndi_config.append( R"(", )" );
+	}
+
+	// Specify codec settings
+	ndi_config.append( R"( "codec": { "shq": { "quality": )" );
+	ndi_config.append( bitrate );
+	ndi_config.append( R"(, "mode": ")" );
+	ndi_config.append( shqmode );
+	ndi_config.append( R"(" } } )" );
+
+	// Restrict the transport and network adapters if requested
+	if (!append_transport_config(ndi_config, transport, adapters, true)) {
+		throw std::runtime_error("Invalid transport configuration!");
+	}
+
+	// Closing braces
+	ndi_config.append( R"(} })" );
+
+	return ndi_config;
+}
+
+std::string make_recv_config(const char* transport, const char* adapters)
+{
+	// Opening stanza
+	std::string ndi_config;
+	ndi_config = R"({ "ndi": { )";
+
+	// Without a valid vendor ID, the Embedded NDI stack runs in demo mode for 30 minutes
+	// If you have a valid vendor ID, add it below, eg:
+	// ndi_config.append( R"("vendor": { "name": "My Company", "id": "00000000000000000000000000000000000000000000", } )";
+
+	// Restrict the transport and network adapters if requested
+	// Some transports (eg: mTCP and UDP) use a *LOT* of CPU on lower end
+	// platforms (eg: 32-bit ARM), use ndirx -B to compare them
+	if (!append_transport_config(ndi_config, transport, adapters, false)) {
+		throw std::runtime_error("Invalid transport configuration!");
+	}
+
+	// Closing braces
+	ndi_config.append( R"(} })" );
+
+	return ndi_config;
+}
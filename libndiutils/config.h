@@ -0,0 +1,19 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Create a JSON configuration string for an NDI sender
+// bitrate is the SpeedHQ quality percentage (eg: "100") and shqmode is
+// "auto", "4:2:0", or "4:2:2".  machinename, transport, and adapters may be
+// NULL to use the NDI defaults (see append_transport_config()).
+// Throws if the transport is not recognized.
+std::string make_send_config(const char* machinename, const std::string& bitrate, const std::string& shqmode,
+	const char* transport=NULL, const char* adapters=NULL);
+
+// Create a JSON configuration string for an NDI receiver
+// transport and adapters may be NULL to use the NDI defaults
+// Throws if the transport is not recognized.
+std::string make_recv_config(const char* transport=NULL, const char* adapters=NULL);
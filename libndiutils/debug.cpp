@@ -0,0 +1,14 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "../ndi_common/debug.h"
+
+// Default global debug variables, from debug.h
+// These are in their own object so the linker only pulls them out of the
+// library when the program doesn't define its own
+FILE *dbgstream = stderr;
+int  debug_level = LOG_ERR;
+bool debug_flush = false;
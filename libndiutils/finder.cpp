@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndiutils.h"
+
+finder::finder(void)
+{
+	LOG(LOG_INFO, "finder Constructor\n");
+
+	// Create a finder instance
+	m_ndi_find = NDIlib_find_create_v2();
+	if (!m_ndi_find) throw std::runtime_error("Cannot create NDI finder!");
+}
+
+finder::~finder(void)
+{
+	LOG(LOG_INFO, "finder Destructor\n");
+
+	NDIlib_find_destroy(m_ndi_find);
+}
+
+const NDIlib_source_t* finder::wait_for_first_source(void)
+{
+	uint32_t num_sources = 0;
+	const NDIlib_source_t* p_sources = NULL;
+
+	// Wait until there is at least one source
+	while (!num_sources)
+	{	// Wait until the sources on the network have changed
+		LOG(LOG_INFO, "Looking for sources ...\n");
+		p_sources = get_sources(1000/* One second */, &num_sources);
+	}
+
+	LOG(LOG_INFO, "Found %u sources\n", num_sources);
+
+	// Use the first source found
+	return &p_sources[0];
+}
+
+const NDIlib_source_t* finder::get_sources(uint32_t timeout_in_ms, uint32_t* num_sources)
+{
+	NDIlib_find_wait_for_sources(m_ndi_find, timeout_in_ms);
+	return NDIlib_find_get_current_sources(m_ndi_find, num_sources);
+}
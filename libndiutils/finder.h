@@ -0,0 +1,26 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Finds NDI sources on the network
+// Sources returned are only valid until the next call or until the finder
+// is destroyed, copy what you need (or connect a receiver) before then
+struct finder
+{
+	// Constructor and destructor
+	finder(void);
+	~finder(void);
+
+	// Wait until there is at least one source and return the first one
+	const NDIlib_source_t* wait_for_first_source(void);
+
+	// Wait up to timeout_in_ms for the sources on the network to change and
+	// return the current list
+	const NDIlib_source_t* get_sources(uint32_t timeout_in_ms, uint32_t* num_sources);
+private:
+	// NDI Finder
+	NDIlib_find_instance_t m_ndi_find;
+};
@@ -0,0 +1,12 @@
+local_dir  := $(subdirectory)
+local_lib  := $(local_dir)/libndiutils.a
+local_src  := $(wildcard $(local_dir)/*.cpp)
+local_objs := $(call src_to_obj, $(local_src) $(ndi_common))
+
+libraries  += $(local_lib)
+sources    += $(local_src)
+
+# Programs link against the library instead of the individual objects
+libndiutils := $(local_lib)
+
+$(local_lib): $(local_objs)
@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// libndiutils: the NDI sending and receiving used by nditx and ndirx, for use
+// in other programs without going through pipes.  Link with libndiutils.a and
+// the NDI library.  Debug output goes through the dbgstream, debug_level, and
+// debug_flush variables from debug.h, which a program may define itself.
+// Otherwise the library provides defaults (errors only, to stderr).
+
+// Standard headers
+#include "../ndi_common/stdafx.h"
+
+// Debug logging
+#include "../ndi_common/debug.h"
+
+// NDI library
+#include <Processing.NDI.Lib.h>
+#include <Processing.NDI.Advanced.h>
+
+// Queue class
+#include "../ndi_common/queue.h"
+
+// Shared frame buffers
+#include "../ndi_common/buffer_pool.h"
+
+// Utility functions
+#include "../ndi_common/util.h"
+
+// Timing sidecar
+#include "../ndi_common/timing.h"
+
+// Pipeline tracing
+#include "../ndi_common/trace.h"
+
+// Transport selection
+#include "../ndi_common/transport.h"
+
+// A/V timestamp log
+#include "../ndi_common/timestamp_log.h"
+
+// NDI configuration
+#include "config.h"
+
+// Source discovery
+#include "finder.h"
+
+// NDI receiver
+#include "receiver.h"
+
+// NDI sender
+#include "sender.h"
+
+// File output
+#include "writer.h"
+
+// Receive loop
+#include "recorder.h"
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndiutils.h"
+
+receiver::receiver(const NDIlib_source_t& source, const std::string& ndi_config, const char* recv_name)
+{
+	LOG(LOG_INFO, "receiver Constructor\n");
+
+	// Configure our receiver settings
+	NDIlib_recv_create_v3_t my_settings;
+	my_settings.source_to_connect_to = NULL; // Specified later
+	my_settings.color_format = (NDIlib_recv_color_format_e) NDIlib_recv_color_format_best;
+	my_settings.bandwidth = NDIlib_recv_bandwidth_highest;
+	my_settings.allow_video_fields = true;
+	my_settings.p_ndi_recv_name = recv_name;
+
+	LOG(LOG_INFO, "ndi_config: %s\n",  ndi_config.c_str());
+
+	// Create an NDI receiver
+	m_ndi_recv = NDIlib_recv_create_v4(&my_settings, ndi_config.c_str());
+	if (!m_ndi_recv) throw std::runtime_error("Cannot create NDI Receiver!");
+
+	// Connect to our source
+	LOG(LOG_INFO, "Connecting to %s\n", source.p_ndi_name);
+	NDIlib_recv_connect(m_ndi_recv, &source);
+}
+
+receiver::~receiver(void)
+{
+	LOG(LOG_INFO, "receiver Destructor\n");
+
+	// Destroy the receiver
+	NDIlib_recv_destroy(m_ndi_recv);
+}
+
+NDIlib_frame_type_e receiver::capture(std::shared_ptr<NDIlib_video_frame_v2_t>* video,
+	std::shared_ptr<NDIlib_audio_frame_v3_t>* audio, uint32_t timeout_in_ms)
+{
+	NDIlib_video_frame_v2_t video_frame;
+	NDIlib_audio_frame_v3_t audio_frame;
+
+	NDIlib_frame_type_e frame_type = NDIlib_recv_capture_v3(m_ndi_recv, &video_frame, audio ? &audio_frame : NULL, NULL, timeout_in_ms);
+
+	NDIlib_recv_instance_t ndi_recv = m_ndi_recv;
+	if (frame_type == NDIlib_frame_type_video) {
+		// Free the video data when the last reference is released
+		// Only frames with data are numbered, as they are by ndirx
+		uint64_t frame_no = video_frame.p_data ? m_frames++ : m_frames;
+		*video = std::shared_ptr<NDIlib_video_frame_v2_t>(new NDIlib_video_frame_v2_t(video_frame),
+			[ndi_recv, frame_no](NDIlib_video_frame_v2_t* p) {
+				trace_span span("free", frame_no);
+				NDIlib_recv_free_video_v2(ndi_recv, p);
+				delete p;
+			});
+	} else if (frame_type == NDIlib_frame_type_audio) {
+		// Free the audio data when the last reference is released
+		*audio = std::shared_ptr<NDIlib_audio_frame_v3_t>(new NDIlib_audio_frame_v3_t(audio_frame),
+			[ndi_recv](NDIlib_audio_frame_v3_t* p) {
+				NDIlib_recv_free_audio_v3(ndi_recv, p);
+				delete p;
+			});
+	}
+
+	return frame_type;
+}
+
+void receiver::begin(video_callback on_video, audio_callback on_audio)
+{
+	m_on_video = on_video;
+	m_on_audio = on_audio;
+
+	// Start a thread to receive frames
+	m_running = true;
+	m_thread = std::thread(&receiver::receive_frames, this);
+}
+
+void receiver::flush(void)
+{
+	LOG(LOG_INFO, "Stopping receive thread\n");
+
+	// The thread notices within one capture timeout
+	m_running = false;
+	if (m_thread.joinable()) m_thread.join();
+
+	LOG(LOG_INFO, "Receive thread stopped\n");
+}
+
+void receiver::receive_frames(void)
+{
+	pthread_setname_np(pthread_self(), "ndi_receive");
+	LOG(LOG_INFO, "receiver thread\n");
+
+	std::shared_ptr<NDIlib_video_frame_v2_t> video_frame;
+	std::shared_ptr<NDIlib_audio_frame_v3_t> audio_frame;
+
+	while (m_running)
+	{
+		// Wait for up to 100ms so we notice being stopped
+		NDIlib_frame_type_e frame_type = capture(&video_frame, m_on_audio ? &audio_frame : NULL, 100);
+
+		if (frame_type == NDIlib_frame_type_video) {
+			m_on_video(video_frame);
+			video_frame.reset();
+		} else if (frame_type == NDIlib_frame_type_audio) {
+			m_on_audio(audio_frame);
+			audio_frame.reset();
+		}
+	}
+}
@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Receives P216 video (and optionally audio) from an NDI source
+//
+// Frames are handed out zero-copy as reference counted pointers to the NDI
+// library's own buffers.  The buffers are returned to the NDI library when
+// the last reference is released (eg: with reset()), so frames can be shared
+// between threads, but must all be released before the receiver is destroyed.
+// Holding on to many frames makes the NDI library allocate more buffers.
+//
+// Frames can be pulled with capture(), or pushed to callbacks from a receive
+// thread started with begin().
+struct receiver
+{
+	typedef std::function<void(std::shared_ptr<NDIlib_video_frame_v2_t>)> video_callback;
+	typedef std::function<void(std::shared_ptr<NDIlib_audio_frame_v3_t>)> audio_callback;
+
+	// Constructor and destructor
+	receiver(const NDIlib_source_t& source, const std::string& ndi_config, const char* recv_name="ndirx");
+	~receiver(void);
+
+	// Wait up to timeout_in_ms for a frame
+	// audio may be NULL to discard audio.  Returns the type of frame received,
+	// setting video or audio for NDIlib_frame_type_video or _audio.
+	NDIlib_frame_type_e capture(std::shared_ptr<NDIlib_video_frame_v2_t>* video,
+		std::shared_ptr<NDIlib_audio_frame_v3_t>* audio, uint32_t timeout_in_ms);
+
+	// Start a thread calling on_video (and on_audio, if not empty) for each
+	// frame received.  Don't call capture() while the thread is running.
+	void begin(video_callback on_video, audio_callback on_audio=nullptr);
+
+	// Stop calling back and wait for the receive thread to exit
+	void flush(void);
+
+	// The NDI receiver, eg: for a frame synchronizer or performance counters
+	NDIlib_recv_instance_t get_instance(void) { return m_ndi_recv; }
+private:
+	// Receive frames for the callbacks
+	void receive_frames(void);
+
+	// NDI receiver
+	NDIlib_recv_instance_t m_ndi_recv;
+
+	// Video frames with data captured, used to label trace events
+	uint64_t m_frames = 0;
+
+	// Callbacks
+	video_callback m_on_video;
+	audio_callback m_on_audio;
+
+	// The receive thread
+	std::atomic<bool> m_running{false};
+	std::thread m_thread;
+};
@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndiutils.h"
+
+recorder::recorder(receiver* recv)
+	: m_recv(recv)
+{
+	LOG(LOG_INFO, "recorder Constructor\n");
+}
+
+recorder::~recorder(void)
+{
+	LOG(LOG_INFO, "recorder Destructor\n");
+}
+
+void recorder::add_output(video_output output)
+{
+	m_outputs.push_back(output);
+}
+
+void recorder::on_receive(receiver::video_callback on_video)
+{
+	m_on_video = on_video;
+}
+
+void recorder::set_audio_output(receiver::audio_callback on_audio)
+{
+	m_on_audio = on_audio;
+}
+
+void recorder::set_paced_source(paced_source source, int rate_n, int rate_d)
+{
+	m_paced = source;
+	m_rate_n = rate_n;
+	m_rate_d = rate_d;
+}
+
+bool recorder::capture(std::shared_ptr<NDIlib_video_frame_v2_t>* frame, int* copies, uint64_t frame_no)
+{
+	*copies = 1;
+
+	if (m_paced) {
+		// Wait for the next tick of our output clock
+		trace_span span("capture", frame_no);
+		return m_paced(frame, copies);
+	}
+
+	// Keep tabs on our performance
+	NDIlib_recv_queue_t recv_q;
+	NDIlib_recv_get_queue(m_recv->get_instance(), &recv_q);
+	LOG(LOG_INFO, "q%i", recv_q.video_frames);
+
+	// Wait for up to 1 second to see if there are any frames available
+	NDIlib_frame_type_e frame_type;
+	std::shared_ptr<NDIlib_audio_frame_v3_t> a_frame;
+
+	{
+		trace_span span("capture", frame_no);
+		frame_type = m_recv->capture(frame, m_on_audio ? &a_frame : NULL, 1000);
+	}
+
+	if (frame_type == NDIlib_frame_type_audio) {
+		// Received an audio frame, pass it straight on
+		m_on_audio(a_frame);
+	} else if (frame_type == NDIlib_frame_type_video) {
+		// Received a video frame
+		m_active = true;
+	} else if (frame_type == NDIlib_frame_type_none) {
+		if (m_active) {
+			// We were seeing video frames, but not any more
+			// Our sender probably went away, give it a few
+			// seconds and then exit cleanly
+			if (m_delay++ >= 5) return false;
+		}
+	}
+
+	return true;
+}
+
+uint64_t recorder::run(int num_frames, bool interactive)
+{
+	// Setup to poll stdin to see if read data is available
+	pollfd fds[1];
+	fds[0].fd = STDIN_FILENO;
+	fds[0].events = POLLIN;
+	fds[0].revents = 0;
+
+	// Frames output so far
+	uint64_t frame_count = 0;
+
+	while ((num_frames != 0) && !m_stop)
+	{
+		// Check for user abort (data available on stdin)
+		if (interactive && (poll(fds, 1, 0) != 0)) {
+			break;
+		}
+
+		// Write the trace if requested
+		trace_poll();
+
+		// The frame to output, how many times to output it, and when it arrived
+		std::shared_ptr<NDIlib_video_frame_v2_t> s_frame;
+		int copies;
+
+		if (!capture(&s_frame, &copies, frame_count)) break;
+		uint64_t recv_ns = monotonic_ns();
+		if (!s_frame) continue;
+		LOG(LOG_INFO, ".");
+
+		// Frames without any video data aren't output, and don't get an
+		// output frame number
+		if (!s_frame->p_data) {
+			LOG(LOG_WARN,"N");	// No data in NDI frame!
+			continue;
+		}
+
+		if (m_on_video) m_on_video(s_frame);
+
+		// Make sure it's the format we expect!
+		if (s_frame->FourCC != NDIlib_FourCC_type_P216) {
+			throw std::runtime_error("Unexpected video format!");
+		}
+
+		for (int i=0; (i<copies) && (num_frames != 0); i++) {
+			// Pass the frame to every output.  Repeated copies fill ticks
+			// which passed while we were late, so they are due one tick
+			// apart ending with the last copy at the receive time, keeping
+			// the due times increasing
+			uint64_t tick_ns = m_rate_n ? (copies - 1 - i) * 1000000000ULL * m_rate_d / m_rate_n : 0;
+			trace_event("queued", frame_count);
+			for (auto& output : m_outputs) {
+				output(s_frame, frame_count, recv_ns - tick_ns);
+				if (m_stop) break;
+			}
+
+			// An output rejected the frame
+			if (m_stop) break;
+			frame_count++;
+
+			// Keep going until we're finished
+			if (num_frames > 0) num_frames--;
+		}
+	}
+
+	return frame_count;
+}
@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Records P216 video (and optionally audio) from a receiver, passing every
+// output frame to each output in the order they were added.  Outputs are
+// called on the recording thread, so they should queue the frame for their
+// own thread rather than process it (eg: writer).
+//
+// Output frames are numbered from 0, and every trace event of a frame is
+// labelled with its output number.  With a paced source a frame may be
+// output several times, its capture and free are labelled with the number
+// of its first copy.
+struct recorder
+{
+	// Called with each output frame, its output frame number, and when it
+	// is due (from monotonic_ns()).  Repeated copies are one tick apart,
+	// ending with the last copy at the receive time.
+	typedef std::function<void(std::shared_ptr<NDIlib_video_frame_v2_t>, uint64_t, uint64_t)> video_output;
+
+	// Waits for the next output tick, setting the frame to output (NULL for
+	// none) and how many ticks it has to fill.  Returns false once the source
+	// has gone away.
+	typedef std::function<bool(std::shared_ptr<NDIlib_video_frame_v2_t>*, int*)> paced_source;
+
+	// Constructor and destructor
+	recorder(receiver* recv);
+	~recorder(void);
+
+	// Add an output for every video frame
+	void add_output(video_output output);
+
+	// Call on_video for every video frame received, before it is output
+	void on_receive(receiver::video_callback on_video);
+
+	// Pass audio straight to on_audio, instead of discarding it
+	void set_audio_output(receiver::audio_callback on_audio);
+
+	// Pull frames from source at rate_n/rate_d, instead of from the receiver
+	void set_paced_source(paced_source source, int rate_n, int rate_d);
+
+	// Record until num_frames have been output (forever if negative), the
+	// source goes away, (if interactive) there is input on stdin, or stop()
+	// is called.  Returns the number of frames output.
+	uint64_t run(int num_frames, bool interactive);
+
+	// Stop recording, eg: from an output which cannot take a frame
+	// The current frame is not passed to any later outputs
+	void stop(void) { m_stop = true; }
+private:
+	// Wait for the next frame to output, returns false when we should stop
+	bool capture(std::shared_ptr<NDIlib_video_frame_v2_t>* frame, int* copies, uint64_t frame_no);
+
+	// NDI receiver
+	receiver* m_recv;
+
+	// Where frames go
+	std::vector<video_output> m_outputs;
+	receiver::video_callback m_on_video;
+	receiver::audio_callback m_on_audio;
+
+	// Optional paced source, and its output frame rate
+	paced_source m_paced;
+	int m_rate_n = 0;
+	int m_rate_d = 1;
+
+	// Seen video from the receiver, and timeouts since
+	bool m_active = false;
+	int m_delay = 0;
+
+	// Set by stop()
+	std::atomic<bool> m_stop{false};
+};
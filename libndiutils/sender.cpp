@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndiutils.h"
+
+sender::sender(const char* ndi_name, const std::string& ndi_config, const NDIlib_video_frame_v2_t& video_format,
+	bool clock_video)
+	: m_video_format(video_format)
+{
+	LOG(LOG_INFO, "sender Constructor\n");
+
+	// Configure our sender settings
+	NDIlib_send_create_t my_settings;
+	my_settings.p_ndi_name = ndi_name;
+	my_settings.p_groups = nullptr;
+	my_settings.clock_video = clock_video;
+	my_settings.clock_audio = false;
+
+	LOG(LOG_INFO, "ndi_config: %s\n",  ndi_config.c_str());
+
+	// Create an NDI sender
+	m_ndi_send = NDIlib_send_create_v2(&my_settings, ndi_config.c_str());
+	if (!m_ndi_send) throw std::runtime_error("Cannot create NDI Sender!");
+}
+
+sender::~sender(void)
+{
+	LOG(LOG_INFO, "sender Destructor\n");
+
+	// Destroy the sender
+	NDIlib_send_destroy(m_ndi_send);
+}
+
+void sender::set_schedule(std::shared_ptr<const std::vector<timing_record>> schedule, uint64_t start_ns)
+{
+	m_schedule = schedule;
+	m_start_ns = start_ns;
+}
+
+void sender::begin(void)
+{
+	// Configure the queue to not drop any frames, the buffer pool limits
+	// how far ahead of the senders the input can get
+	m_frame_q.set_depth(0);
+
+	// Start a thread to send frames
+	m_thread = std::thread(&sender::send_frames, this);
+}
+
+bool sender::add_frame(std::shared_ptr<uint8_t> frame)
+{
+	// NULL is passed to indicate the send thread should exit
+	return m_frame_q.push(frame);
+}
+
+void sender::flush(void)
+{
+	LOG(LOG_INFO, "Flushing %i elements from queue\n", m_frame_q.get_depth());
+
+	// Submit an empty frame and wait for the thread to exit
+	add_frame(NULL);
+	m_thread.join();
+
+	LOG(LOG_INFO, "Queue flushed\n");
+}
+
+int sender::get_no_connections(uint32_t timeout_in_ms)
+{
+	return NDIlib_send_get_no_connections(m_ndi_send, timeout_in_ms);
+}
+
+void sender::send_audio(const NDIlib_audio_frame_v3_t* audio_frame)
+{
+	// The NDI library allows audio and video to be sent from different threads
+	NDIlib_send_send_audio_v3(m_ndi_send, audio_frame);
+}
+
+void sender::send_frames(void)
+{
+	pthread_setname_np(pthread_self(), "video_send");
+	LOG(LOG_INFO, "sender thread\n");
+
+	NDIlib_video_frame_v2_t video_frame = m_video_format;
+
+	// With asynchronous sending the NDI library keeps using a buffer until
+	// the next call to NDIlib_send_send_video_async_v2, so hold on to our
+	// reference to the previous frame until then
+	std::shared_ptr<uint8_t> frame;
+	std::shared_ptr<uint8_t> prev_frame;
+	size_t index = 0;
+
+	// Replay timing is more accurate if we aren't preempted
+	if (m_schedule && !set_max_priority()) {
+		LOG(LOG_INFO, "Unable to raise priority of send thread\n");
+	}
+
+	// Cycle forever, exit when we get sent an empty frame
+	while (true)
+	{
+		// Get a frame to send from the queue
+		frame = m_frame_q.pop();
+
+		// An empty frame is submitted as a signal to exit the thread
+		if (!frame) break;
+
+		// Wait until the recorded receive time of this frame, and reuse its
+		// timecode, to reproduce the original cadence including bursts and gaps
+		if (m_schedule && (index < m_schedule->size())) {
+			const timing_record& record = (*m_schedule)[index];
+			sleep_until_ns(m_start_ns + record.recv_ns);
+			video_frame.timecode = record.timecode;
+		}
+
+		// Send the frame to our NDI sender
+		video_frame.p_data = frame.get();
+		{
+			trace_span span("submit", index);
+			NDIlib_send_send_video_async_v2(m_ndi_send, &video_frame);
+		}
+		index++;
+
+		// The NDI library is now done with the previous frame
+		prev_frame = frame;
+	}
+
+	// Make sure NDI has sent our last frame
+	NDIlib_send_send_video_async_v2(m_ndi_send, NULL);
+	prev_frame.reset();
+}
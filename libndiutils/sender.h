@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Sends caller owned P216 frame buffers on its own thread
+// Frames are sent asynchronously, each buffer is held until the NDI library
+// is done with it and then released, so a buffer pool can be shared with
+// other senders.
+struct sender
+{
+	// Constructor and destructor
+	// The NDI library paces sending to the frame rate when clock_video is set
+	sender(const char* ndi_name, const std::string& ndi_config, const NDIlib_video_frame_v2_t& video_format,
+		bool clock_video=true);
+	~sender(void);
+
+	// Send each frame at the receive time recorded in a timing sidecar,
+	// relative to start_ns (from monotonic_ns()), instead of at a fixed rate
+	// Must be called before begin()
+	void set_schedule(std::shared_ptr<const std::vector<timing_record>> schedule, uint64_t start_ns);
+
+	// Start processing thread
+	void begin(void);
+
+	// Add a frame buffer for sending
+	bool add_frame(std::shared_ptr<uint8_t> frame);
+
+	// Finish sending all queued frames
+	void flush(void);
+
+	// Get the number of connected receivers
+	int get_no_connections(uint32_t timeout_in_ms);
+
+	// Send audio, may be called from any thread
+	void send_audio(const NDIlib_audio_frame_v3_t* audio_frame);
+private:
+	// Send frames
+	void send_frames(void);
+
+	// NDI Sender
+	NDIlib_send_instance_t m_ndi_send;
+
+	// Video settings for every frame we send
+	NDIlib_video_frame_v2_t m_video_format;
+
+	// Optional replay schedule
+	std::shared_ptr<const std::vector<timing_record>> m_schedule;
+	uint64_t m_start_ns = 0;
+
+	// Queue for frame buffers
+	queue<uint8_t> m_frame_q;
+
+	// The processing thread
+	std::thread m_thread;
+};
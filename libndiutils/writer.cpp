@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndiutils.h"
+
+writer::writer(FILE *outfile, timestamp_log* ts_log)
+	: m_outfile(outfile), m_ts_log(ts_log)
+{
+	LOG(LOG_INFO, "writer Constructor\n");
+}
+
+writer::~writer(void)
+{
+	LOG(LOG_INFO, "writer Destructor\n");
+}
+
+void writer::begin(void)
+{
+	// Configure the queue to not drop any frames
+	m_ndi_q.set_depth(0);
+
+	// Start a thread to process frames
+	m_thread = std::thread(&writer::write_frames, this);
+}
+
+bool writer::add_frame(std::shared_ptr<NDIlib_video_frame_v2_t> frame)
+{
+	// Bail if there is no data!
+	if ((frame) && (!frame->p_data))
+	{
+		LOG(LOG_WARN,"N");	// No data in NDI frame!
+		return true;
+	}
+
+	// let's add it to the queue!
+	// NULL is passed to indicate the decode thread should exit
+	return m_ndi_q.push(frame);
+}
+
+void writer::flush(void)
+{
+	LOG(LOG_INFO, "Flushing %i elements from queue\n", m_ndi_q.get_depth());
+
+	// Submit an empty frame and wait for the thread to exit
+	add_frame(NULL);
+	m_thread.join();
+
+	LOG(LOG_INFO, "Queue flushed\n");
+}
+
+void writer::write_frames(void)
+{
+	pthread_setname_np(pthread_self(), "video_decode");
+	LOG(LOG_INFO, "writer thread\n");
+
+	// Local temporary variable to hold details of a compressed frame
+	std::shared_ptr<NDIlib_video_frame_v2_t> video_frame;
+
+	// Cycle forever, exit when we get sent an empty frame
+	while (true)
+	{
+		// Get a frame to process from the queue
+		video_frame = m_ndi_q.pop();
+
+		// Indicate frame "popped" from the queue
+		LOG(LOG_DBG, "p");	// Popped video frame from NDI queue
+
+		// An empty frame is submitted as a signal to exit the thread
+		if (!video_frame) break;
+		trace_event("popped", m_frames);
+
+		// Calculate expected line stride and frame size
+		int line_stride =  video_frame->xres * sizeof(uint16_t);
+		size_t frame_size = line_stride * video_frame->yres * 2;
+
+		// Sanity check, we don't currently handle non-packed line stride
+		if (line_stride != video_frame->line_stride_in_bytes) {
+			LOG(LOG_ERR, "%i:%i\n", line_stride, video_frame->line_stride_in_bytes);
+			throw std::runtime_error("Unsupported line stride!");
+		}
+
+		// Write video data
+		{
+			trace_span span("write", m_frames);
+			size_t wlen = fwrite(video_frame->p_data, 1, frame_size, m_outfile);
+			if (wlen != frame_size) {
+				throw std::runtime_error("Something went wrong writing the output file!\n");
+			}
+		}
+
+		if (m_ts_log) m_ts_log->video(m_frames, video_frame->timestamp, video_frame->timecode);
+		m_frames++;
+
+		// Release our reference, the video data is freed once every
+		// consumer of the frame is done with it
+		video_frame.reset();
+	}
+}
@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Writes received P216 frames to a file on its own thread, to disconnect
+// write performance from NDI receiving performance.  No frames are dropped,
+// frames are queued until they have been written.
+struct writer
+{
+	// Constructor and destructor
+	writer(FILE *outfile, timestamp_log* ts_log=NULL);
+	~writer(void);
+
+	// Start processing thread
+	void begin(void);
+
+	// Add a captured frame for processing
+	bool add_frame(std::shared_ptr<NDIlib_video_frame_v2_t> frame);
+
+	// Finish processessing all queued frames
+	void flush(void);
+private:
+	// Process frames
+	void write_frames(void);
+
+	// Output file
+	FILE *m_outfile;
+
+	// Optional timestamp log
+	timestamp_log* m_ts_log;
+	uint64_t m_frames = 0;
+
+	// Queue for NDI frames
+	queue<NDIlib_video_frame_v2_t> m_ndi_q;
+
+	// The processing thread
+	std::thread m_thread;
+};
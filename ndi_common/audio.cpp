@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "audio.h"
+
+#define WAV_FORMAT_PCM          (1)
+#define WAV_FORMAT_FLOAT        (3)
+#define WAV_FORMAT_EXTENSIBLE   (0xFFFE)
+
+// WAV files are little-endian, as are all the platforms we build for
+static uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+static void put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+
+bool wav_read_header(FILE *infile, wav_format* format)
+{
+	uint8_t header[12];
+	if (fread(header, 1, sizeof(header), infile) != sizeof(header)) return false;
+	if (memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4)) return false;
+
+	bool have_format = false;
+
+	// Walk the chunks until we find the sample data
+	while (true)
+	{
+		uint8_t chunk[8];
+		if (fread(chunk, 1, sizeof(chunk), infile) != sizeof(chunk)) return false;
+		uint32_t size = get32(chunk + 4);
+
+		if (!memcmp(chunk, "data", 4)) {
+			return have_format;
+		}
+
+		std::vector<uint8_t> body(size + (size & 1));
+		if (fread(body.data(), 1, body.size(), infile) != body.size()) return false;
+
+		if (!memcmp(chunk, "fmt ", 4) && (size >= 16)) {
+			uint16_t tag = get16(&body[0]);
+			format->channels = get16(&body[2]);
+			format->sample_rate = get32(&body[4]);
+			format->bits = get16(&body[14]);
+
+			// The real format tag follows the extension header
+			if ((tag == WAV_FORMAT_EXTENSIBLE) && (size >= 26)) {
+				tag = get16(&body[24]);
+			}
+
+			format->is_float = (tag == WAV_FORMAT_FLOAT);
+			if ((tag != WAV_FORMAT_PCM) && (tag != WAV_FORMAT_FLOAT)) return false;
+			if (format->is_float && (format->bits != 32)) return false;
+			if ((format->bits != 16) && (format->bits != 32)) return false;
+			if ((format->channels <= 0) || (format->sample_rate <= 0)) return false;
+
+			have_format = true;
+		}
+	}
+}
+
+void wav_write_header(FILE *outfile, int sample_rate, int channels, uint64_t data_bytes)
+{
+	// Unknown or oversized lengths are written as the maximum, which most
+	// readers treat as "until end of file"
+	uint32_t data_size = ((data_bytes == 0) || (data_bytes > 0xFFFFFFFFULL - 36)) ? 0xFFFFFFFFU - 36 : (uint32_t)data_bytes;
+
+	uint8_t header[44];
+	memcpy(header, "RIFF", 4);
+	put32(header + 4, data_size + 36);
+	memcpy(header + 8, "WAVEfmt ", 8);
+	put32(header + 16, 16);
+	put16(header + 20, WAV_FORMAT_PCM);
+	put16(header + 22, channels);
+	put32(header + 24, sample_rate);
+	put32(header + 28, sample_rate * channels * sizeof(int32_t));
+	put16(header + 32, channels * sizeof(int32_t));
+	put16(header + 34, 32);
+	memcpy(header + 36, "data", 4);
+	put32(header + 40, data_size);
+
+	if (fwrite(header, 1, sizeof(header), outfile) != sizeof(header)) {
+		throw std::runtime_error("Something went wrong writing the audio file!\n");
+	}
+}
+
+void planar_to_interleaved_s32(const uint8_t* src, int channel_stride_in_bytes,
+	int channels, int samples, int32_t* dst, std::vector<int32_t>& scratch)
+{
+	scratch.resize((size_t)samples);
+
+	for (int c=0; c<channels; c++) {
+		const float* in = (const float*)(src + (size_t)c * channel_stride_in_bytes);
+
+		// Scale and clamp to the 32-bit range.  Written as simple compares
+		// and a truncating conversion so the loop vectorizes (min/max and
+		// cvttps2dq on x86, fmin/fmax and fcvtzs on ARM).  Truncation costs
+		// less than one LSB of 32-bit audio.
+		for (int i=0; i<samples; i++) {
+			float v = in[i] * 2147483648.0f;
+			v = (v < -2147483648.0f) ? -2147483648.0f : v;
+			v = (v > 2147483520.0f) ? 2147483520.0f : v;
+			scratch[i] = (int32_t) v;
+		}
+
+		// Interleave this channel into the output
+		int32_t* out = dst + c;
+		for (int i=0; i<samples; i++) {
+			out[(size_t)i * channels] = scratch[i];
+		}
+	}
+}
+
+void interleaved_to_planar(const uint8_t* src, const wav_format& format,
+	int samples, float* dst, int channel_stride_in_floats)
+{
+	int channels = format.channels;
+
+	for (int c=0; c<channels; c++) {
+		float* out = dst + (size_t)c * channel_stride_in_floats;
+
+		if (format.is_float) {
+			const float* in = (const float*)src + c;
+			for (int i=0; i<samples; i++) out[i] = in[(size_t)i * channels];
+		} else if (format.bits == 16) {
+			const int16_t* in = (const int16_t*)src + c;
+			for (int i=0; i<samples; i++) out[i] = in[(size_t)i * channels] * (1.0f / 32768.0f);
+		} else {
+			const int32_t* in = (const int32_t*)src + c;
+			for (int i=0; i<samples; i++) out[i] = in[(size_t)i * channels] * (1.0f / 2147483648.0f);
+		}
+	}
+}
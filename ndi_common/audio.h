@@ -0,0 +1,33 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Sample format of a WAV file
+struct wav_format
+{
+	int sample_rate;
+	int channels;
+	int bits;		// 16 or 32
+	bool is_float;	// 32-bit IEEE float rather than integer PCM
+};
+
+// Read the header of a WAV file, leaving the file positioned at the start of
+// the sample data.  Returns false if the file is not a supported WAV file.
+bool wav_read_header(FILE *infile, wav_format* format);
+
+// Write the header of a 32-bit integer PCM WAV file.  Pass 0 for data_bytes
+// if the length is not yet known, the header can be rewritten later if the
+// output is seekable.
+void wav_write_header(FILE *outfile, int sample_rate, int channels, uint64_t data_bytes);
+
+// Convert NDI planar float audio to interleaved 32-bit PCM
+// scratch is working space reused between calls
+void planar_to_interleaved_s32(const uint8_t* src, int channel_stride_in_bytes,
+	int channels, int samples, int32_t* dst, std::vector<int32_t>& scratch);
+
+// Convert interleaved WAV samples to NDI planar float audio
+void interleaved_to_planar(const uint8_t* src, const wav_format& format,
+	int samples, float* dst, int channel_stride_in_floats);
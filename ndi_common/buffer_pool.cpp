@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "buffer_pool.h"
+
+buffer_pool::buffer_pool(size_t buffer_size, int buffer_count)
+	: m_size(buffer_size)
+{
+	LOG(LOG_INFO, "buffer_pool: %i buffers of %zu bytes\n", buffer_count, buffer_size);
+
+	for (int i=0; i<buffer_count; i++) {
+		uint8_t* buffer = (uint8_t*) malloc(buffer_size);
+		if (!buffer) throw std::runtime_error("Cannot allocate pool buffer!");
+		m_buffers.push_back(buffer);
+	}
+
+	m_free = m_buffers;
+}
+
+buffer_pool::~buffer_pool(void)
+{
+	// Every buffer must have been returned before the pool goes away
+	if (m_free.size() != m_buffers.size()) {
+		LOG(LOG_ERR, "buffer_pool: %zu buffers still in use!\n", m_buffers.size() - m_free.size());
+	}
+
+	for (auto buffer : m_buffers) {
+		free(buffer);
+	}
+}
+
+std::shared_ptr<uint8_t> buffer_pool::get(void)
+{
+	// Lock the pool
+	std::unique_lock<std::mutex> lock_pool(m_lock);
+
+	// Wait until someone releases a buffer
+	while (m_free.empty())
+		m_condvar.wait(lock_pool);
+
+	uint8_t* buffer = m_free.back();
+	m_free.pop_back();
+
+	// The deleter hands the buffer back to us instead of freeing it
+	return std::shared_ptr<uint8_t>(buffer, [this](uint8_t* p) { put(p); });
+}
+
+void buffer_pool::put(uint8_t* buffer)
+{
+	// Lock the pool
+	std::unique_lock<std::mutex> lock_pool(m_lock);
+
+	m_free.push_back(buffer);
+
+	// Unlock and then wake up anyone waiting for a buffer
+	lock_pool.unlock();
+	m_condvar.notify_one();
+}
@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// A fixed set of equally sized buffers shared between threads.  Buffers are
+// handed out as reference counted pointers and automatically return to the
+// pool when the last reference is released.
+struct buffer_pool
+{
+	// Constructor and destructor
+	buffer_pool(size_t buffer_size, int buffer_count);
+	~buffer_pool(void);
+
+	// Get a free buffer (blocks until one is available)
+	std::shared_ptr<uint8_t> get(void);
+
+	// Get the size of each buffer in bytes
+	size_t get_size(void) { return m_size; }
+
+private:
+	// Return a buffer to the pool
+	void put(uint8_t* buffer);
+
+	// Size of each buffer
+	size_t m_size;
+
+	// All allocated buffers, and the ones currently free
+	std::vector<uint8_t*> m_buffers;
+	std::vector<uint8_t*> m_free;
+
+	// The lock and condition variable
+	std::mutex m_lock;
+	std::condition_variable m_condvar;
+};
@@ -0,0 +1,235 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "queue.h"
+#include "hash.h"
+
+#include <cinttypes>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#define HASH_LANES          (8)
+#define HASH_STRIPE         (HASH_LANES * sizeof(uint64_t))
+#define HASH_BLOCK_STRIPES  (16)
+
+static const uint64_t PRIME32_1 = 0x9E3779B1U;
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+
+// Per lane keys, mixed into the data before multiplying
+static const uint64_t hash_keys[HASH_LANES] = {
+	0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL,
+	0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+	0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL,
+	0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+};
+
+static inline uint64_t read64(const uint8_t* p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t avalanche(uint64_t h)
+{
+	h ^= h >> 37;
+	h *= PRIME64_3;
+	h ^= h >> 32;
+	return h;
+}
+
+// Accumulate one 64 byte stripe and scramble the accumulators, with SIMD
+// versions for x86 and ARM.  All versions produce identical results.
+#if defined(__SSE2__)
+static inline void accumulate_stripe(uint64_t* acc, const uint8_t* p)
+{
+	for (int i=0; i<HASH_LANES; i+=2) {
+		__m128i data = _mm_loadu_si128((const __m128i*)(p + i * sizeof(uint64_t)));
+		__m128i key  = _mm_xor_si128(data, _mm_loadu_si128((const __m128i*)&hash_keys[i]));
+		__m128i a    = _mm_loadu_si128((__m128i*)&acc[i]);
+
+		a = _mm_add_epi64(a, _mm_mul_epu32(key, _mm_srli_epi64(key, 32)));
+		a = _mm_add_epi64(a, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)));
+		_mm_storeu_si128((__m128i*)&acc[i], a);
+	}
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+static inline void accumulate_stripe(uint64_t* acc, const uint8_t* p)
+{
+	for (int i=0; i<HASH_LANES; i+=2) {
+		uint64x2_t data = vld1q_u64((const uint64_t*)(p + i * sizeof(uint64_t)));
+		uint64x2_t key  = veorq_u64(data, vld1q_u64(&hash_keys[i]));
+		uint64x2_t a    = vld1q_u64(&acc[i]);
+
+		a = vmlal_u32(a, vmovn_u64(key), vshrn_n_u64(key, 32));
+		a = vaddq_u64(a, vextq_u64(data, data, 1));
+		vst1q_u64(&acc[i], a);
+	}
+}
+#else
+static inline void accumulate_stripe(uint64_t* acc, const uint8_t* p)
+{
+	for (int i=0; i<HASH_LANES; i++) {
+		uint64_t data = read64(p + i * sizeof(uint64_t));
+		uint64_t key = data ^ hash_keys[i];
+		acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+		acc[i] += read64(p + (i ^ 1) * sizeof(uint64_t));
+	}
+}
+#endif
+
+static inline void scramble(uint64_t* acc)
+{
+	for (int i=0; i<HASH_LANES; i++) {
+		uint64_t a = acc[i];
+		a ^= a >> 47;
+		a ^= hash_keys[i];
+		acc[i] = a * PRIME32_1;
+	}
+}
+
+uint64_t hash64(const uint8_t* data, size_t len)
+{
+	uint64_t acc[HASH_LANES] = {
+		PRIME32_1, PRIME64_1, PRIME64_2, PRIME64_3,
+		PRIME64_1 ^ len, PRIME64_2, PRIME32_1, PRIME64_3,
+	};
+
+	const uint8_t* p = data;
+	size_t remaining = len;
+
+	// Whole blocks, scrambling the accumulators after each
+	while (remaining >= HASH_STRIPE * HASH_BLOCK_STRIPES) {
+		for (int s=0; s<HASH_BLOCK_STRIPES; s++) {
+			accumulate_stripe(acc, p);
+			p += HASH_STRIPE;
+		}
+		scramble(acc);
+		remaining -= HASH_STRIPE * HASH_BLOCK_STRIPES;
+	}
+
+	// Remaining whole stripes
+	while (remaining >= HASH_STRIPE) {
+		accumulate_stripe(acc, p);
+		p += HASH_STRIPE;
+		remaining -= HASH_STRIPE;
+	}
+
+	// Merge the lanes
+	uint64_t h = len * PRIME64_1;
+	for (int i=0; i<HASH_LANES; i++) {
+		h ^= avalanche(acc[i] + hash_keys[i]);
+		h = (h << 27 | h >> 37) * PRIME64_1;
+	}
+
+	// Any trailing bytes
+	while (remaining >= sizeof(uint64_t)) {
+		h ^= avalanche(read64(p) * PRIME64_2);
+		h = (h << 27 | h >> 37) * PRIME64_1;
+		p += sizeof(uint64_t);
+		remaining -= sizeof(uint64_t);
+	}
+	while (remaining) {
+		h ^= (*p) * PRIME64_3;
+		h = (h << 11 | h >> 53) * PRIME64_1;
+		p++;
+		remaining--;
+	}
+
+	return avalanche(h);
+}
+
+hasher::hasher(FILE *logfile, int num_threads)
+	: m_logfile(logfile), m_num_threads(num_threads)
+{
+	LOG(LOG_INFO, "hasher Constructor\n");
+}
+
+hasher::~hasher(void)
+{
+	LOG(LOG_INFO, "hasher Destructor\n");
+}
+
+void hasher::begin(void)
+{
+	// Configure the queue to not drop any frames
+	m_job_q.set_depth(0);
+
+	// Start threads to hash frames
+	for (int i=0; i<m_num_threads; i++) {
+		m_threads.push_back(std::thread(&hasher::hash_frames, this));
+	}
+}
+
+void hasher::add_frame(std::shared_ptr<void> owner, const uint8_t* data, size_t size)
+{
+	std::shared_ptr<job> s_job = std::make_shared<job>();
+	s_job->index = m_next_index++;
+	s_job->owner = owner;
+	s_job->data = data;
+	s_job->size = size;
+
+	m_job_q.push(s_job);
+}
+
+void hasher::flush(void)
+{
+	LOG(LOG_INFO, "Flushing %i elements from hash queue\n", m_job_q.get_depth());
+
+	// Submit an empty job per thread and wait for them to exit
+	for (int i=0; i<m_num_threads; i++) {
+		m_job_q.push(NULL);
+	}
+	for (auto& t : m_threads) {
+		t.join();
+	}
+	m_threads.clear();
+
+	fflush(m_logfile);
+
+	LOG(LOG_INFO, "Hash queue flushed\n");
+}
+
+void hasher::hash_frames(void)
+{
+	pthread_setname_np(pthread_self(), "frame_hash");
+	LOG(LOG_INFO, "hasher thread\n");
+
+	std::shared_ptr<job> frame_job;
+
+	// Cycle forever, exit when we get sent an empty job
+	while (true)
+	{
+		frame_job = m_job_q.pop();
+
+		// An empty job is submitted as a signal to exit the thread
+		if (!frame_job) break;
+
+		uint64_t hash = hash64(frame_job->data, frame_job->size);
+
+		// Release the frame as soon as possible
+		uint64_t index = frame_job->index;
+		frame_job.reset();
+
+		// Log every hash that is now in order
+		std::unique_lock<std::mutex> lock_results(m_lock);
+		m_results[index] = hash;
+
+		auto it = m_results.begin();
+		while ((it != m_results.end()) && (it->first == m_next_log)) {
+			fprintf(m_logfile, "%" PRIu64 " %016" PRIx64 "\n", it->first, it->second);
+			it = m_results.erase(it);
+			m_next_log++;
+		}
+	}
+}
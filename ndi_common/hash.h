@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Fast 64-bit hash of a block of memory, used to verify frame payloads are
+// bit-exact between runs.  The algorithm follows the XXH3 design (eight
+// 64-bit accumulator lanes fed with 32x32->64 multiplies, periodically
+// scrambled) so the compiler can vectorize the inner loop, but the output is
+// NOT compatible with xxhsum.  Only compare hashes produced by this function.
+uint64_t hash64(const uint8_t* data, size_t len);
+
+// Hash log written by the hasher and read by ndicmp, one line per frame:
+//   <frame number> <hash as 16 hex digits>
+struct hasher
+{
+	// Constructor and destructor
+	hasher(FILE *logfile, int num_threads=4);
+	~hasher(void);
+
+	// Start processing threads
+	void begin(void);
+
+	// Add a frame for hashing
+	// owner keeps the data valid until the hash has been calculated
+	void add_frame(std::shared_ptr<void> owner, const uint8_t* data, size_t size);
+
+	// Finish hashing all queued frames
+	void flush(void);
+private:
+	// A queued frame
+	struct job
+	{
+		uint64_t index;
+		std::shared_ptr<void> owner;
+		const uint8_t* data;
+		size_t size;
+	};
+
+	// Hash frames
+	void hash_frames(void);
+
+	// Output file
+	FILE *m_logfile;
+
+	// Frames are hashed in parallel but logged in order
+	uint64_t m_next_index = 0;
+	uint64_t m_next_log = 0;
+	std::map<uint64_t, uint64_t> m_results;
+	std::mutex m_lock;
+
+	// Queue for frames
+	queue<job> m_job_q;
+
+	// The processing threads
+	int m_num_threads;
+	std::vector<std::thread> m_threads;
+};
@@ -15,12 +15,19 @@
 #include <string>
 
 // TODO: reference additional headers your program requires here
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include <fcntl.h>
 #include <poll.h>
 #include <unistd.h>
+#include <sys/uio.h>
@@ -0,0 +1,38 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "timestamp_log.h"
+
+#include <cinttypes>
+
+timestamp_log::timestamp_log(FILE *logfile)
+	: m_logfile(logfile)
+{
+	LOG(LOG_INFO, "timestamp_log Constructor\n");
+
+	fprintf(m_logfile, "# V <frame> <timestamp> <timecode>\n");
+	fprintf(m_logfile, "# A <sample> <samples> <timestamp> <timecode>\n");
+}
+
+timestamp_log::~timestamp_log(void)
+{
+	LOG(LOG_INFO, "timestamp_log Destructor\n");
+
+	fflush(m_logfile);
+}
+
+void timestamp_log::video(uint64_t frame, int64_t timestamp, int64_t timecode)
+{
+	std::unique_lock<std::mutex> lock_log(m_lock);
+	fprintf(m_logfile, "V %" PRIu64 " %" PRId64 " %" PRId64 "\n", frame, timestamp, timecode);
+}
+
+void timestamp_log::audio(uint64_t sample, int samples, int64_t timestamp, int64_t timecode)
+{
+	std::unique_lock<std::mutex> lock_log(m_lock);
+	fprintf(m_logfile, "A %" PRIu64 " %i %" PRId64 " %" PRId64 "\n", sample, samples, timestamp, timecode);
+}
@@ -0,0 +1,31 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Text log of the NDI timestamp and timecode of every video frame and audio
+// block written, so recorded audio and video can be aligned after the fact.
+// Shared by the video and audio writer threads.  Lines are:
+//   V <frame number> <timestamp> <timecode>
+//   A <first sample number> <sample count> <timestamp> <timecode>
+// Timestamps and timecodes are in NDI 100ns units.
+struct timestamp_log
+{
+	// Constructor and destructor
+	timestamp_log(FILE *logfile);
+	~timestamp_log(void);
+
+	// Log a video frame
+	void video(uint64_t frame, int64_t timestamp, int64_t timecode);
+
+	// Log a block of audio samples
+	void audio(uint64_t sample, int samples, int64_t timestamp, int64_t timecode);
+private:
+	// Output file
+	FILE *m_logfile;
+
+	// Lines from different threads must not interleave
+	std::mutex m_lock;
+};
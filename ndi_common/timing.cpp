@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "timing.h"
+
+// Buffer enough records that the receive thread only rarely makes a write
+// call, about once every 45 seconds at 60 fps
+#define TIMING_BUFFER_SIZE  (64 * 1024)
+
+timing_writer::timing_writer(FILE *outfile)
+	: m_outfile(outfile)
+{
+	LOG(LOG_INFO, "timing_writer Constructor\n");
+
+	setvbuf(m_outfile, NULL, _IOFBF, TIMING_BUFFER_SIZE);
+
+	timing_header header = { TIMING_MAGIC, TIMING_VERSION, sizeof(timing_record) };
+	if (fwrite(&header, sizeof(header), 1, m_outfile) != 1) {
+		throw std::runtime_error("Something went wrong writing the timing file!\n");
+	}
+}
+
+timing_writer::~timing_writer(void)
+{
+	LOG(LOG_INFO, "timing_writer Destructor\n");
+
+	fflush(m_outfile);
+}
+
+void timing_writer::add_frame(uint64_t recv_ns, int64_t timestamp, int64_t timecode)
+{
+	if (m_first) {
+		m_first_ns = recv_ns;
+		m_first = false;
+	}
+
+	timing_record record = { recv_ns - m_first_ns, timestamp, timecode };
+	if (fwrite(&record, sizeof(record), 1, m_outfile) != 1) {
+		throw std::runtime_error("Something went wrong writing the timing file!\n");
+	}
+}
+
+bool timing_read(FILE *infile, std::vector<timing_record>& records)
+{
+	timing_header header;
+	if (fread(&header, sizeof(header), 1, infile) != 1) return false;
+	if (memcmp(header.magic, TIMING_MAGIC, sizeof(header.magic))) return false;
+	if ((header.version != TIMING_VERSION) || (header.record_size != sizeof(timing_record))) return false;
+
+	timing_record record;
+	while (fread(&record, sizeof(record), 1, infile) == 1) {
+		records.push_back(record);
+	}
+
+	return true;
+}
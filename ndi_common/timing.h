@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Binary timing sidecar written by ndirx and replayed by nditx.  The file is
+// a timing_header followed by one timing_record per frame written, in host
+// (little-endian) byte order.
+#define TIMING_MAGIC    "NDITIME"
+#define TIMING_VERSION  (1)
+
+struct timing_header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+};
+
+struct timing_record
+{
+	// When the frame was received, in ns since the first frame
+	uint64_t recv_ns;
+
+	// NDI timestamp and timecode of the frame, in 100ns units
+	int64_t timestamp;
+	int64_t timecode;
+};
+
+// Writes timing records.  Records are small and buffered, so this is cheap
+// enough to call from the receive thread.
+struct timing_writer
+{
+	// Constructor and destructor
+	timing_writer(FILE *outfile);
+	~timing_writer(void);
+
+	// Add a record for a frame received at recv_ns (from monotonic_ns())
+	void add_frame(uint64_t recv_ns, int64_t timestamp, int64_t timecode);
+private:
+	FILE *m_outfile;
+	uint64_t m_first_ns = 0;
+	bool m_first = true;
+};
+
+// Read all the records from a timing sidecar
+// Returns false if the file is not a valid timing sidecar
+bool timing_read(FILE *infile, std::vector<timing_record>& records);
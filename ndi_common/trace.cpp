@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "util.h"
+#include "trace.h"
+
+#include <cinttypes>
+#include <csignal>
+
+#include <sys/syscall.h>
+
+std::atomic<bool> trace_enabled(false);
+
+namespace {
+
+// A span (duration >= 0) or instant event (duration < 0)
+struct trace_record
+{
+	const char* name;
+	uint64_t start_ns;
+	int64_t duration_ns;
+	uint64_t frame;
+};
+
+// Events recorded by one thread
+// Only the owning thread writes records, and it publishes them by advancing
+// m_count, so a dump can read everything below m_count without locking
+struct thread_buffer
+{
+	static const size_t capacity = 1 << 16;
+
+	thread_buffer(void)
+	{
+		m_tid = syscall(SYS_gettid);
+		m_name[0] = 0;
+		pthread_getname_np(pthread_self(), m_name, sizeof(m_name));
+	}
+
+	void add(const char* name, uint64_t start_ns, int64_t duration_ns, uint64_t frame)
+	{
+		size_t count = m_count.load(std::memory_order_relaxed);
+		if (count >= capacity) {
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		m_records[count] = { name, start_ns, duration_ns, frame };
+		m_count.store(count + 1, std::memory_order_release);
+	}
+
+	long m_tid;
+	char m_name[16];
+	trace_record m_records[capacity];
+	std::atomic<size_t> m_count{0};
+	std::atomic<size_t> m_dropped{0};
+};
+
+// Every thread which has recorded an event, the buffers are kept until exit
+// so events from finished threads are still written
+std::mutex buffers_lock;
+std::vector<thread_buffer*> buffers;
+
+// The calling thread's buffer, created on its first event
+thread_local thread_buffer* my_buffer = NULL;
+
+FILE *trace_file = NULL;
+uint64_t trace_start_ns = 0;
+
+// Set by the SIGUSR1 handler
+volatile sig_atomic_t dump_requested = 0;
+
+thread_buffer* get_buffer(void)
+{
+	if (!my_buffer) {
+		my_buffer = new thread_buffer;
+
+		std::unique_lock<std::mutex> lock_buffers(buffers_lock);
+		buffers.push_back(my_buffer);
+	}
+	return my_buffer;
+}
+
+void sigusr1_handler(int)
+{
+	dump_requested = 1;
+}
+
+// Write all events recorded so far, replacing any previous dump
+void trace_dump(void)
+{
+	std::unique_lock<std::mutex> lock_buffers(buffers_lock);
+
+	rewind(trace_file);
+	if (ftruncate(fileno(trace_file), 0) != 0) {
+		LOG(LOG_WARN, "Unable to truncate trace file\n");
+	}
+
+	pid_t pid = getpid();
+	size_t events = 0;
+	size_t dropped = 0;
+	const char* separator = "";
+
+	fprintf(trace_file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	for (auto b : buffers) {
+		// Name the thread's track
+		fprintf(trace_file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":%li,\"args\":{\"name\":\"%s\"}}",
+			separator, pid, b->m_tid, b->m_name);
+		separator = ",\n";
+
+		size_t count = b->m_count.load(std::memory_order_acquire);
+		for (size_t i=0; i<count; i++) {
+			const trace_record& r = b->m_records[i];
+
+			// Times are in microseconds from the start of tracing
+			int64_t ts = r.start_ns - trace_start_ns;
+			fprintf(trace_file, "%s{\"name\":\"%s\",\"pid\":%i,\"tid\":%li,\"ts\":%" PRId64 ".%03" PRId64,
+				separator, r.name, pid, b->m_tid, ts / 1000, ts % 1000);
+			if (r.duration_ns >= 0) {
+				fprintf(trace_file, ",\"ph\":\"X\",\"dur\":%" PRId64 ".%03" PRId64,
+					r.duration_ns / 1000, r.duration_ns % 1000);
+			} else {
+				fprintf(trace_file, ",\"ph\":\"i\",\"s\":\"t\"");
+			}
+			fprintf(trace_file, ",\"args\":{\"frame\":%" PRIu64 "}}", r.frame);
+		}
+		events += count;
+		dropped += b->m_dropped.load(std::memory_order_relaxed);
+	}
+	fprintf(trace_file, "\n]}\n");
+	fflush(trace_file);
+
+	LOG(LOG_WARN, "Wrote %zu trace events from %zu threads", events, buffers.size());
+	if (dropped) LOG(LOG_WARN, ", dropped %zu", dropped);
+	LOG(LOG_WARN, "\n");
+}
+
+} // namespace
+
+void trace_begin(FILE *tracefile)
+{
+	trace_file = tracefile;
+	trace_start_ns = monotonic_ns();
+
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sigusr1_handler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = SA_RESTART;
+	sigaction(SIGUSR1, &sa, NULL);
+
+	trace_enabled.store(true);
+}
+
+void trace_complete(const char* name, uint64_t start_ns, uint64_t frame)
+{
+	get_buffer()->add(name, start_ns, monotonic_ns() - start_ns, frame);
+}
+
+void trace_instant(const char* name, uint64_t frame)
+{
+	get_buffer()->add(name, monotonic_ns(), -1, frame);
+}
+
+void trace_poll(void)
+{
+	if (dump_requested && trace_file) {
+		dump_requested = 0;
+		trace_dump();
+	}
+}
+
+void trace_end(void)
+{
+	if (!trace_file) return;
+
+	trace_enabled.store(false);
+	trace_dump();
+	trace_file = NULL;
+}
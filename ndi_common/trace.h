@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Opt-in timeline of per-frame pipeline events, written as Chrome trace-event
+// JSON which can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+//
+// Each thread records into its own fixed size buffer, so recording takes no
+// locks.  When tracing is disabled the cost of an event is a single relaxed
+// load of trace_enabled.  Events past the end of a thread's buffer are
+// counted and dropped.
+
+// True while tracing, checked before recording anything
+extern std::atomic<bool> trace_enabled;
+
+// Start recording events, to be written to the specified file
+// Also installs a SIGUSR1 handler which requests a dump
+void trace_begin(FILE *tracefile);
+
+// Record a span which started at start_ns (from monotonic_ns()) and ends now
+// The name must be a string literal, the frame number is shown as an argument
+void trace_complete(const char* name, uint64_t start_ns, uint64_t frame);
+
+// Record an instant event
+void trace_instant(const char* name, uint64_t frame);
+
+// Write everything recorded so far if SIGUSR1 has been received
+// Call regularly from the main loop, the signal handler itself can't do I/O
+void trace_poll(void);
+
+// Write everything recorded so far and stop recording
+void trace_end(void);
+
+// Record a span covering the lifetime of this object
+struct trace_span
+{
+	trace_span(const char* name, uint64_t frame)
+		: m_name(name), m_frame(frame)
+	{
+		if (trace_enabled.load(std::memory_order_relaxed)) m_start_ns = monotonic_ns();
+	}
+
+	~trace_span(void)
+	{
+		if (m_start_ns) trace_complete(m_name, m_start_ns, m_frame);
+	}
+private:
+	const char* m_name;
+	uint64_t m_frame;
+	uint64_t m_start_ns = 0;
+};
+
+// Record an instant event, if tracing
+inline void trace_event(const char* name, uint64_t frame)
+{
+	if (trace_enabled.load(std::memory_order_relaxed)) trace_instant(name, frame);
+}
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stdafx.h"
+#include "util.h"
+#include "transport.h"
+
+namespace {
+
+// Transport names and their NDI configuration keys
+struct transport_key
+{
+	const char* name;
+	const char* key;
+};
+
+const transport_key transports[] = {
+	{ "multicast", "multicast" },
+	{ "tcp", "tcp" },
+	{ "udp", "unicast" },
+	{ "rudp", "rudp" },
+};
+
+// Look up a transport by name
+const transport_key* find_transport(const char* name)
+{
+	for (const auto& t : transports) {
+		if (!strcmp(name, t.name)) return &t;
+	}
+	return NULL;
+}
+
+// Append a member to a JSON object, adding a separator if needed
+void append_member(std::string& ndi_config, const std::string& member)
+{
+	size_t last = ndi_config.find_last_not_of(" \t\n");
+	if ((last != std::string::npos) && (ndi_config[last] != '{') && (ndi_config[last] != ',')) {
+		ndi_config.append( "," );
+	}
+	ndi_config.append( " " );
+	ndi_config.append( member );
+	ndi_config.append( " " );
+}
+
+} // namespace
+
+const char* transport_names(void)
+{
+	return "multicast, tcp, udp, rudp";
+}
+
+bool is_transport(const char* name)
+{
+	return find_transport(name) != NULL;
+}
+
+bool append_transport_config(std::string& ndi_config, const char* transport, const char* adapters, bool send)
+{
+	const char* direction = send ? "send" : "recv";
+
+	if (transport) {
+		const transport_key* selected = find_transport(transport);
+		if (!selected) return false;
+
+		// Enable the selected transport and disable all the others
+		for (const auto& t : transports) {
+			std::string member = std::string("\"") + t.key + "\": { \"" + direction + "\": { \"enable\": "
+				+ ((&t == selected) ? "true" : "false") + " } }";
+			append_member(ndi_config, member);
+		}
+	}
+
+	if (adapters) {
+		// Only use the listed network adapters
+		std::string member = R"("adapters": { "allowed": [)";
+		const char* separator = "";
+		for (const auto& a : split_list(adapters)) {
+			member += std::string(separator) + "\"" + a + "\"";
+			separator = ", ";
+		}
+		member += "] }";
+		append_member(ndi_config, member);
+	}
+
+	return true;
+}
@@ -0,0 +1,19 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Names accepted by append_transport_config(), for usage messages
+const char* transport_names(void);
+
+// Check a transport name is valid
+bool is_transport(const char* name);
+
+// Add NDI JSON configuration restricting the sender or receiver to a single
+// transport (multicast, tcp, udp, or rudp) and/or a comma separated list of
+// network adapter addresses.  Either may be NULL to keep the NDI default.
+// ndi_config must be an open JSON object, eg: { "ndi": { ...
+// Returns false if the transport name is not recognized.
+bool append_transport_config(std::string& ndi_config, const char* transport, const char* adapters, bool send);
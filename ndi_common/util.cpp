@@ -6,6 +6,8 @@
 #include "stdafx.h"
 #include "util.h"
 #include <sys/time.h>
+#include <cerrno>
+#include <ctime>
 
 bool set_max_priority(int offset_from_max)
 {
@@ -18,3 +20,67 @@ bool set_max_priority(int offset_from_max)
 #endif
 }
 
+
+std::vector<std::string> split_list(const char* arg, char separator)
+{
+	std::vector<std::string> items;
+
+	while (arg && *arg) {
+		const char* end = strchr(arg, separator);
+		size_t len = end ? (size_t)(end - arg) : strlen(arg);
+
+		if (len) items.push_back(std::string(arg, len));
+
+		arg = end ? end + 1 : nullptr;
+	}
+
+	return items;
+}
+
+void arg2rate(char* arg, int* rate_n, int* rate_d)
+{
+    if(arg)
+    {
+        char* separator = strchr(arg, '/');
+
+        // See if a range specifier was found
+        if (separator == nullptr) {
+            // No range specifier, just convert to an integer rate
+            *rate_n = strtol(arg, nullptr, 0);
+            *rate_d  = 1;
+            return;
+        }
+
+        // Look for first value
+        if (separator == arg) {
+            // No first value, leave unchanged
+        } else {
+            *rate_n = strtol(arg, nullptr, 0);
+        }
+
+        // Look for last value
+        if (separator == (arg + strlen(arg) - 1)) {
+            // No last value, leave unchanged
+        } else {
+            *rate_d = strtol(separator+1, nullptr, 0);
+        }
+    }
+}
+
+uint64_t monotonic_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void sleep_until_ns(uint64_t deadline_ns)
+{
+	struct timespec ts;
+	ts.tv_sec = deadline_ns / 1000000000ULL;
+	ts.tv_nsec = deadline_ns % 1000000000ULL;
+
+	// Restart if interrupted by a signal
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+	}
+}
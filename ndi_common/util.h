@@ -8,3 +8,18 @@
 // Set the current thread's priority to the max
 // offset_from_max is essentially sched_get_priority_max() - offset_from_max
 bool set_max_priority(int offset_from_max=0);
+
+// Split a separated list of values (eg: "50,100,200") into its elements
+// Empty elements are skipped
+std::vector<std::string> split_list(const char* arg, char separator=',');
+
+// Parse a frame rate of the form "numerator[/denominator]"
+// Missing values are left unchanged
+void arg2rate(char* arg, int* rate_n, int* rate_d);
+
+// Current CLOCK_MONOTONIC time in ns
+uint64_t monotonic_ns(void);
+
+// Sleep until an absolute CLOCK_MONOTONIC time in ns
+// Sleeping to an absolute deadline means wakeup latency doesn't accumulate
+void sleep_until_ns(uint64_t deadline_ns);
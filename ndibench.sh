@@ -0,0 +1,66 @@
+#!/bin/bash
+
+# SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+# SPDX-License-Identifier: MIT
+
+#set -x
+
+function isInt () {
+	if [ -n "${1//[-0-9]/}" ] ; then
+		echo "$1 does not look like an integer!"
+		exit 1
+	fi
+}
+
+function usage () {
+	echo "Usage:"
+	echo "$0 [-x width] [-y height] [-r rate] [-c framecount] [-p pattern] [-N adapter] [-t transports]"
+	echo "    width      : horizontal resolution (default 1920)"
+	echo "    height     : vertical resolution (default 1080)"
+	echo "    rate       : frame rate (default 60000/1001)"
+	echo "    framecount : number of frames to send with each transport (default 600)"
+	echo "    pattern    : nditx test pattern to send (default zoneplate)"
+	echo "    adapter    : network adapter address to use (default: NDI default)"
+	echo "    transports : comma separated list of transports to test (default multicast,tcp,udp,rudp)"
+}
+
+# Default settings
+WIDTH=1920
+HEIGHT=1080
+RATE=60000/1001
+COUNT=600
+PATTERN=zoneplate
+ADAPTER=""
+TRANSPORTS=multicast,tcp,udp,rudp
+
+OPTSTRING="x:y:r:c:p:N:t:"
+
+while getopts ${OPTSTRING} opt; do
+	case ${opt} in
+		x) isInt ${OPTARG} ; WIDTH=${OPTARG} ;;
+		y) isInt ${OPTARG} ; HEIGHT=${OPTARG} ;;
+		r) RATE=${OPTARG} ;;
+		c) isInt ${OPTARG} ; COUNT=${OPTARG} ;;
+		p) PATTERN=${OPTARG} ;;
+		N) ADAPTER="-N ${OPTARG}" ;;
+		t) TRANSPORTS=${OPTARG} ;;
+		?) echo "Argument parsing failed"
+		   usage
+		   exit 1
+		   ;;
+	esac
+done
+
+echo "Sending ${COUNT} ${WIDTH}x${HEIGHT} ${PATTERN} frames @ ${RATE} fps with each transport"
+
+for TRANSPORT in ${TRANSPORTS//,/ } ; do
+	# Launch NDI send process in the background
+	nditx -m ndibench -p ${PATTERN} -x ${WIDTH} -y ${HEIGHT} -r ${RATE} -c ${COUNT} -t ${TRANSPORT} ${ADAPTER} -w > ndibench.${TRANSPORT}.nditx.log 2>&1 &
+
+	# Receive and report the benchmark results
+	ndirx -s "NDIBENCH (nditx)" -c ${COUNT} -t ${TRANSPORT} ${ADAPTER} -B -o /dev/null > ndibench.${TRANSPORT}.ndirx.log 2>&1
+	grep "^transport=" ndibench.${TRANSPORT}.ndirx.log
+
+	# Wait for the NDI send process to finish
+	wait
+done
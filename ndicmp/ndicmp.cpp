@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndicmp.h"
+
+#include <cinttypes>
+
+// Global debug variables, from debug.h
+FILE *dbgstream = stderr;
+int  debug_level = LOG_ERR;
+bool debug_flush = false;
+
+// Read the next entry from a hash log, returns false at end of file
+bool read_hash(FILE *logfile, uint64_t* index, uint64_t* hash)
+{
+	return fscanf(logfile, "%" SCNu64 " %" SCNx64, index, hash) == 2;
+}
+
+int main(int argc, char* argv[])
+{
+	debug_flush = false;
+
+	// Passed on the command line
+	int opt;
+	while ((opt = getopt(argc, argv, "vqf")) != -1) {
+		switch (opt) {
+		// Debugging
+		case 'v':	// Increase debugging level
+			debug_level++;
+			break;
+		case 'q':	// Decrease debugging level
+			if (debug_level > 0) debug_level--;
+			break;
+		case 'f':	// fflush() debug messages
+			debug_flush = true;
+			break;
+
+		default:	// '?'
+			fprintf(stderr, "Usage: %s [-vqf] <hashlog> <reference hashlog>\n", argv[0]);
+			fprintf(stderr, "  Compare two hash logs written by nditx or ndirx with -H and report the first diverging frame\n");
+			fprintf(stderr, "  -v Increase debugging output level\n");
+			fprintf(stderr, "  -q Decrease debugging output level\n");
+			fprintf(stderr, "  -f fflush() after each debug message\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (argc - optind != 2) {
+		fprintf(stderr, "Expected two hash logs, try: %s -h\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	FILE *log[2];
+	for (int i=0; i<2; i++) {
+		log[i] = fopen(argv[optind + i], "r");
+		if (log[i] == NULL) {
+			fprintf (stderr, "Cannot open %s for reading!\n", argv[optind + i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	uint64_t frames = 0;
+	uint64_t index[2];
+	uint64_t hash[2];
+
+	// Walk both logs in step until one runs out or they differ
+	while (true)
+	{
+		bool valid[2];
+		for (int i=0; i<2; i++) {
+			valid[i] = read_hash(log[i], &index[i], &hash[i]);
+		}
+
+		if (!valid[0] && !valid[1]) {
+			printf("Identical: %" PRIu64 " frames\n", frames);
+			return 0;
+		}
+
+		if (!valid[0] || !valid[1]) {
+			printf("Length differs: %s ends after %" PRIu64 " frames\n",
+				argv[optind + (valid[0] ? 1 : 0)], frames);
+			return 1;
+		}
+
+		if (index[0] != index[1]) {
+			printf("Frame numbering differs at entry %" PRIu64 ": %" PRIu64 " vs %" PRIu64 "\n",
+				frames, index[0], index[1]);
+			return 1;
+		}
+
+		LOG(LOG_DBG, "%" PRIu64 " %016" PRIx64 " %016" PRIx64 "\n", index[0], hash[0], hash[1]);
+
+		if (hash[0] != hash[1]) {
+			printf("First diverging frame: %" PRIu64 " (%016" PRIx64 " vs %016" PRIx64 ")\n",
+				index[0], hash[0], hash[1]);
+			return 1;
+		}
+
+		frames++;
+	}
+}
@@ -0,0 +1,9 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Debug logging
+#include "../ndi_common/debug.h"
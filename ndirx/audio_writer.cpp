@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndirx.h"
+
+// Maximum number of queued audio frames (several seconds at typical sizes)
+// If the output stalls for longer than that the oldest audio is dropped
+#define AUDIO_QUEUE_DEPTH   (512)
+
+audio_writer::audio_writer(FILE *outfile, timestamp_log* ts_log)
+	: m_outfile(outfile), m_ts_log(ts_log)
+{
+	LOG(LOG_INFO, "audio_writer Constructor\n");
+}
+
+audio_writer::~audio_writer(void)
+{
+	LOG(LOG_INFO, "audio_writer Destructor\n");
+}
+
+void audio_writer::begin(void)
+{
+	// Bound the queue so a stalled output can't use up all our memory
+	m_ndi_q.set_depth(AUDIO_QUEUE_DEPTH);
+
+	// Start a thread to process frames
+	m_thread = std::thread(&audio_writer::write_frames, this);
+}
+
+bool audio_writer::add_frame(std::shared_ptr<NDIlib_audio_frame_v3_t> frame)
+{
+	// Bail if there is no data!
+	if ((frame) && (!frame->p_data))
+	{
+		LOG(LOG_WARN,"n");	// No data in NDI audio frame!
+		return true;
+	}
+
+	// NULL is passed to indicate the thread should exit
+	return m_ndi_q.push(frame);
+}
+
+void audio_writer::flush(void)
+{
+	LOG(LOG_INFO, "Flushing %i elements from audio queue\n", m_ndi_q.get_depth());
+
+	// Submit an empty frame and wait for the thread to exit
+	add_frame(NULL);
+	m_thread.join();
+
+	// Fill in the real length if we can seek back to the header
+	if (m_channels && (fseek(m_outfile, 0, SEEK_SET) == 0)) {
+		wav_write_header(m_outfile, m_sample_rate, m_channels, m_samples * m_channels * sizeof(int32_t));
+	}
+	fflush(m_outfile);
+
+	LOG(LOG_INFO, "Audio queue flushed\n");
+}
+
+void audio_writer::write_frames(void)
+{
+	pthread_setname_np(pthread_self(), "audio_write");
+	LOG(LOG_INFO, "audio_writer thread\n");
+
+	std::shared_ptr<NDIlib_audio_frame_v3_t> audio_frame;
+
+	// Cycle forever, exit when we get sent an empty frame
+	while (true)
+	{
+		audio_frame = m_ndi_q.pop();
+
+		// An empty frame is submitted as a signal to exit the thread
+		if (!audio_frame) break;
+
+		if (audio_frame->FourCC != NDIlib_FourCC_audio_type_FLTP) {
+			LOG(LOG_ERR, "Unexpected audio format!\n");
+			continue;
+		}
+
+		// The first frame sets the format of the file
+		if (!m_channels) {
+			m_sample_rate = audio_frame->sample_rate;
+			m_channels = audio_frame->no_channels;
+			LOG(LOG_WARN, "Audio: %i channels @ %i Hz\n", m_channels, m_sample_rate);
+			wav_write_header(m_outfile, m_sample_rate, m_channels, 0);
+		}
+
+		if ((audio_frame->sample_rate != m_sample_rate) || (audio_frame->no_channels != m_channels)) {
+			LOG(LOG_ERR, "Audio format changed, skipping audio!\n");
+			continue;
+		}
+
+		int samples = audio_frame->no_samples;
+		m_interleaved.resize((size_t)samples * m_channels);
+		planar_to_interleaved_s32(audio_frame->p_data, audio_frame->channel_stride_in_bytes,
+			m_channels, samples, m_interleaved.data(), m_scratch);
+
+		if (m_ts_log) {
+			m_ts_log->audio(m_samples, samples, audio_frame->timestamp, audio_frame->timecode);
+		}
+
+		// Done with the NDI frame
+		audio_frame.reset();
+
+		// Write audio data
+		size_t wlen = fwrite(m_interleaved.data(), sizeof(int32_t), m_interleaved.size(), m_outfile);
+		if (wlen != m_interleaved.size()) {
+			throw std::runtime_error("Something went wrong writing the audio file!\n");
+		}
+
+		m_samples += samples;
+	}
+}
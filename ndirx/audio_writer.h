@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Writes received audio as a 32-bit PCM WAV file on its own thread, with its
+// own queue, so audio and video writes can never hold each other up.
+struct audio_writer
+{
+	// Constructor and destructor
+	audio_writer(FILE *outfile, timestamp_log* ts_log);
+	~audio_writer(void);
+
+	// Start processing thread
+	void begin(void);
+
+	// Add a captured audio frame for processing
+	bool add_frame(std::shared_ptr<NDIlib_audio_frame_v3_t> frame);
+
+	// Finish processessing all queued frames
+	void flush(void);
+private:
+	// Process frames
+	void write_frames(void);
+
+	// Output file and optional timestamp log
+	FILE *m_outfile;
+	timestamp_log* m_ts_log;
+
+	// Format of the output, set by the first frame
+	int m_sample_rate = 0;
+	int m_channels = 0;
+	uint64_t m_samples = 0;
+
+	// Conversion buffers
+	std::vector<int32_t> m_interleaved;
+	std::vector<int32_t> m_scratch;
+
+	// Queue for NDI frames
+	queue<NDIlib_audio_frame_v3_t> m_ndi_q;
+
+	// The processing thread
+	std::thread m_thread;
+};
@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndirx.h"
+
+#include <cinttypes>
+
+#include <sys/resource.h>
+
+benchmark::benchmark(NDIlib_recv_instance_t ndi_recv, const char* label)
+	: m_ndi_recv(ndi_recv), m_label(label ? label : "default")
+{
+	LOG(LOG_INFO, "benchmark Constructor\n");
+}
+
+benchmark::~benchmark(void)
+{
+	LOG(LOG_INFO, "benchmark Destructor\n");
+}
+
+double benchmark::cpu_seconds(void)
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+		+ (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+void benchmark::add_frame(size_t frame_size)
+{
+	if (!m_frames) {
+		// Start measuring from the first frame
+		m_start_ns = monotonic_ns();
+		m_start_cpu = cpu_seconds();
+		m_start_dropped = get_dropped();
+	} else {
+		// Frames after the first one were received in the measured interval
+		m_bytes += frame_size;
+	}
+
+	m_end_ns = monotonic_ns();
+	m_end_cpu = cpu_seconds();
+	m_frames++;
+}
+
+int64_t benchmark::get_dropped(void)
+{
+	// Frames the NDI library received and dropped, which we never saw
+	NDIlib_recv_performance_t total;
+	NDIlib_recv_performance_t dropped;
+	NDIlib_recv_get_performance(m_ndi_recv, &total, &dropped);
+
+	return dropped.video_frames;
+}
+
+void benchmark::report(void)
+{
+	// The NDI counters are cumulative, only report drops since the first frame
+	int64_t dropped = m_frames ? get_dropped() - m_start_dropped : 0;
+
+	// The interval covers the frames after the first one
+	uint64_t intervals = m_frames ? m_frames - 1 : 0;
+	double seconds = (m_end_ns - m_start_ns) / 1e9;
+	double cpu = m_end_cpu - m_start_cpu;
+
+	fprintf(stderr, "transport=%s frames=%" PRIu64 " dropped=%" PRId64 " seconds=%.3f fps=%.2f MBps=%.1f cpu_ms_per_frame=%.3f cpu_percent=%.1f\n",
+		m_label.c_str(), m_frames, dropped, seconds,
+		(seconds > 0) ? intervals / seconds : 0.0,
+		(seconds > 0) ? m_bytes / seconds / 1e6 : 0.0,
+		intervals ? cpu * 1000.0 / intervals : 0.0,
+		(seconds > 0) ? cpu * 100.0 / seconds : 0.0);
+}
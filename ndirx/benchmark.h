@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Measures the cost of receiving: process CPU time per frame (including the
+// NDI library's own threads), throughput, and frames dropped by the NDI
+// receiver.  Measurement starts with the first frame, so discovery and
+// connection setup are not included.
+struct benchmark
+{
+	// Constructor and destructor
+	// The label (eg: the transport) is included in the report
+	benchmark(NDIlib_recv_instance_t ndi_recv, const char* label);
+	~benchmark(void);
+
+	// Count a received frame of the specified size
+	void add_frame(size_t frame_size);
+
+	// Report results to stderr as a single line of name=value pairs
+	void report(void);
+private:
+	// Process user + system CPU time in seconds
+	static double cpu_seconds(void);
+
+	// Video frames dropped by the NDI receiver since it was created
+	int64_t get_dropped(void);
+
+	// NDI receiver
+	NDIlib_recv_instance_t m_ndi_recv;
+
+	std::string m_label;
+
+	// State at the first frame
+	uint64_t m_start_ns = 0;
+	double m_start_cpu = 0;
+	int64_t m_start_dropped = 0;
+
+	// State at the last frame
+	uint64_t m_end_ns = 0;
+	double m_end_cpu = 0;
+
+	uint64_t m_frames = 0;
+	uint64_t m_bytes = 0;
+};
@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndirx.h"
+
+#include <cerrno>
+#include <climits>
+
+bool parse_crop(const char* arg, crop_spec* crop)
+{
+	int len = 0;
+	if (sscanf(arg, "%i,%i,%i,%i:%n", &crop->x, &crop->y, &crop->w, &crop->h, &len) != 4) return false;
+	if (!len || !arg[len]) return false;
+
+	crop->path = arg + len;
+
+	return (crop->x >= 0) && (crop->y >= 0) && (crop->w > 0) && (crop->h > 0)
+		&& !(crop->x & 1) && !(crop->w & 1);
+}
+
+// Write all of a gather list, which may take several calls
+static void write_all(int fd, struct iovec* iov, size_t count)
+{
+	while (count) {
+		ssize_t wlen = writev(fd, iov, std::min(count, (size_t)IOV_MAX));
+		if (wlen < 0) {
+			if (errno == EINTR) continue;
+			throw std::runtime_error("Something went wrong writing a crop file!\n");
+		}
+
+		// Skip everything that was written
+		while (count && ((size_t)wlen >= iov->iov_len)) {
+			wlen -= iov->iov_len;
+			iov++;
+			count--;
+		}
+		if (count) {
+			iov->iov_base = (uint8_t*)iov->iov_base + wlen;
+			iov->iov_len -= wlen;
+		}
+	}
+}
+
+crop_writer::crop_writer(FILE *outfile, const crop_spec& crop)
+	: m_outfile(outfile), m_crop(crop), m_iov(crop.h * 2)
+{
+	LOG(LOG_INFO, "crop_writer Constructor\n");
+}
+
+crop_writer::~crop_writer(void)
+{
+	LOG(LOG_INFO, "crop_writer Destructor\n");
+}
+
+void crop_writer::begin(void)
+{
+	// Configure the queue to not drop any frames
+	m_ndi_q.set_depth(0);
+
+	// Start a thread to process frames
+	m_thread = std::thread(&crop_writer::write_frames, this);
+}
+
+bool crop_writer::fits(const NDIlib_video_frame_v2_t& frame)
+{
+	if ((m_crop.x + m_crop.w > frame.xres) || (m_crop.y + m_crop.h > frame.yres)) {
+		LOG(LOG_ERR, "Crop %ix%i+%i+%i is outside the %ix%i frame!\n",
+			m_crop.w, m_crop.h, m_crop.x, m_crop.y, frame.xres, frame.yres);
+		return false;
+	}
+
+	return true;
+}
+
+void crop_writer::add_frame(std::shared_ptr<NDIlib_video_frame_v2_t> frame)
+{
+	// NULL is passed to indicate the write thread should exit
+	m_ndi_q.push(frame);
+}
+
+void crop_writer::flush(void)
+{
+	LOG(LOG_INFO, "Flushing %i elements from crop queue\n", m_ndi_q.get_depth());
+
+	// Submit an empty frame and wait for the thread to exit
+	add_frame(NULL);
+	m_thread.join();
+
+	LOG(LOG_INFO, "Crop queue flushed\n");
+}
+
+void crop_writer::write_frames(void)
+{
+	pthread_setname_np(pthread_self(), "crop_write");
+	LOG(LOG_INFO, "crop_writer thread\n");
+
+	// Nothing else writes to the file, so bypass stdio
+	fflush(m_outfile);
+	int fd = fileno(m_outfile);
+
+	// Local temporary variable to hold details of a frame
+	std::shared_ptr<NDIlib_video_frame_v2_t> video_frame;
+
+	// Cycle forever, exit when we get sent an empty frame
+	while (true)
+	{
+		// Get a frame to process from the queue
+		video_frame = m_ndi_q.pop();
+
+		// An empty frame is submitted as a signal to exit the thread
+		if (!video_frame) break;
+
+		// The UV plane follows the Y plane and has the same layout, the
+		// U and V samples of each pixel pair are interleaved
+		int stride = video_frame->line_stride_in_bytes;
+		uint8_t* y_plane = video_frame->p_data;
+		uint8_t* uv_plane = y_plane + (size_t)stride * video_frame->yres;
+		size_t offset = (size_t)m_crop.y * stride + m_crop.x * sizeof(uint16_t);
+		size_t len = m_crop.w * sizeof(uint16_t);
+
+		for (int row=0; row<m_crop.h; row++) {
+			m_iov[row].iov_base = y_plane + offset + (size_t)row * stride;
+			m_iov[row].iov_len = len;
+			m_iov[m_crop.h + row].iov_base = uv_plane + offset + (size_t)row * stride;
+			m_iov[m_crop.h + row].iov_len = len;
+		}
+
+		write_all(fd, m_iov.data(), m_iov.size());
+
+		// Release our reference, the video data is freed once every
+		// consumer of the frame is done with it
+		video_frame.reset();
+	}
+}
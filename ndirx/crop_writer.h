@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// A window of the received frames, and where to write it
+struct crop_spec
+{
+	int x, y, w, h;
+	std::string path;
+};
+
+// Parse a crop of the form "x,y,w,h:file"
+// x and w must be even so the interleaved UV samples stay paired
+bool parse_crop(const char* arg, crop_spec* crop);
+
+// Writes a window of each received frame as a smaller P216 frame on its own
+// thread.  The rows of the Y and UV planes are gathered with writev()
+// straight from the NDI buffer, so no copy of the frame is made.
+struct crop_writer
+{
+	// Constructor and destructor
+	crop_writer(FILE *outfile, const crop_spec& crop);
+	~crop_writer(void);
+
+	// Start processing thread
+	void begin(void);
+
+	// Whether the crop is inside the frame, logging an error if not
+	// Check each frame with this before adding it
+	bool fits(const NDIlib_video_frame_v2_t& frame);
+
+	// Add a captured frame for processing
+	void add_frame(std::shared_ptr<NDIlib_video_frame_v2_t> frame);
+
+	// Finish processessing all queued frames
+	void flush(void);
+private:
+	// Process frames
+	void write_frames(void);
+
+	// Output file
+	FILE *m_outfile;
+
+	// Window to write
+	crop_spec m_crop;
+
+	// One entry per row of each plane
+	std::vector<struct iovec> m_iov;
+
+	// Queue for NDI frames
+	queue<NDIlib_video_frame_v2_t> m_ndi_q;
+
+	// The processing thread
+	std::thread m_thread;
+};
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndirx.h"
+
+frame_sync::frame_sync(NDIlib_recv_instance_t ndi_recv, int rate_n, int rate_d)
+	: m_rate_n(rate_n), m_rate_d(rate_d)
+{
+	LOG(LOG_INFO, "frame_sync Constructor\n");
+
+	if ((rate_n <= 0) || (rate_d <= 0)) {
+		throw std::runtime_error("Invalid frame sync rate!");
+	}
+
+	m_ndi_fs = NDIlib_framesync_create(ndi_recv);
+	if (!m_ndi_fs) throw std::runtime_error("Cannot create NDI frame synchronizer!");
+
+	m_start = std::chrono::steady_clock::now();
+}
+
+frame_sync::~frame_sync(void)
+{
+	LOG(LOG_INFO, "frame_sync Destructor\n");
+
+	// Every frame we handed out must have been released by now
+	NDIlib_framesync_destroy(m_ndi_fs);
+}
+
+std::chrono::nanoseconds frame_sync::tick_time(uint64_t tick)
+{
+	// Exact for any rational rate, without overflowing on long captures
+	const uint64_t ns = 1000000000ULL;
+	uint64_t whole = (tick / m_rate_n) * m_rate_d * ns;
+	uint64_t part = (tick % m_rate_n) * m_rate_d * ns / m_rate_n;
+	return std::chrono::nanoseconds(whole + part);
+}
+
+std::shared_ptr<NDIlib_video_frame_v2_t> frame_sync::capture(int* ticks)
+{
+	// Sleep until the absolute deadline of this tick, so any jitter in our
+	// own scheduling doesn't accumulate
+	std::this_thread::sleep_until(m_start + tick_time(m_tick));
+
+	// If we woke up more than a tick late, the frame fills every tick that
+	// has already passed so the output stays aligned with wall time
+	*ticks = 1;
+	auto now = std::chrono::steady_clock::now();
+	while (m_start + tick_time(m_tick + *ticks) <= now) {
+		(*ticks)++;
+	}
+	m_tick += *ticks;
+
+	NDIlib_video_frame_v2_t video_frame;
+	NDIlib_framesync_capture_video(m_ndi_fs, &video_frame, NDIlib_frame_format_type_progressive);
+
+	// Nothing received from the source yet
+	if (!video_frame.p_data) {
+		NDIlib_framesync_free_video(m_ndi_fs, &video_frame);
+		return NULL;
+	}
+
+	m_frames += *ticks;
+	m_late += *ticks - 1;
+
+	// Work out how the source frame relates to the previous one
+	if (video_frame.timestamp != NDIlib_recv_timestamp_undefined) {
+		if (video_frame.timestamp == m_last_timestamp) {
+			// Same frame as last time
+			m_repeated += *ticks;
+			m_held += *ticks;
+			LOG(LOG_INFO, "R");	// Repeated a frame
+		} else {
+			// Count any source frames that were skipped since the last one
+			if ((m_last_timestamp != NDIlib_recv_timestamp_undefined) && (video_frame.frame_rate_N > 0)) {
+				int64_t period = 10000000LL * video_frame.frame_rate_D / video_frame.frame_rate_N;
+				int64_t missed = (video_frame.timestamp - m_last_timestamp + period / 2) / period - 1;
+				if (missed > 0) {
+					m_dropped += missed;
+					LOG(LOG_INFO, "D");	// Dropped a frame
+				}
+			}
+			m_repeated += *ticks - 1;
+			m_held = 0;
+			m_last_timestamp = video_frame.timestamp;
+		}
+	}
+
+	// Frames from the synchronizer are returned to it, not the receiver
+	NDIlib_framesync_instance_t ndi_fs = m_ndi_fs;
+	// Trace events are labelled with the output frame number of the first copy
+	uint64_t frame = m_frames - *ticks;
+	return std::shared_ptr<NDIlib_video_frame_v2_t>(new NDIlib_video_frame_v2_t(video_frame),
+		[ndi_fs, frame](NDIlib_video_frame_v2_t* p) {
+			trace_span span("free", frame);
+			NDIlib_framesync_free_video(ndi_fs, p);
+			delete p;
+		});
+}
+
+double frame_sync::get_held_time(void)
+{
+	return (double)m_held * m_rate_d / m_rate_n;
+}
+
+void frame_sync::report(void)
+{
+	LOG(LOG_WARN, "Frame sync: %llu frames output, %llu repeated (%llu late), %llu dropped\n",
+		(unsigned long long)m_frames, (unsigned long long)m_repeated,
+		(unsigned long long)m_late, (unsigned long long)m_dropped);
+}
@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Pulls frames from the NDI frame synchronizer at an exact local frame rate,
+// so the output cadence follows our clock instead of the sender's.  The
+// synchronizer repeats or skips source frames as needed and always returns
+// the most recent frame, so it adds no more than about one frame of latency.
+// Repeated and dropped source frames are counted for reporting.
+struct frame_sync
+{
+	// Constructor and destructor
+	frame_sync(NDIlib_recv_instance_t ndi_recv, int rate_n, int rate_d);
+	~frame_sync(void);
+
+	// Wait for the next output tick and return the frame to output.  Returns
+	// NULL until the source has sent its first frame.  If we woke up late,
+	// ticks is set to the number of output ticks the frame has to fill.
+	std::shared_ptr<NDIlib_video_frame_v2_t> capture(int* ticks);
+
+	// How long the source has been sending the same frame, in seconds
+	double get_held_time(void);
+
+	// Report statistics
+	void report(void);
+private:
+	// Time of an output tick relative to the start
+	std::chrono::nanoseconds tick_time(uint64_t tick);
+
+	// NDI Frame synchronizer
+	NDIlib_framesync_instance_t m_ndi_fs;
+
+	// Output frame rate
+	int m_rate_n;
+	int m_rate_d;
+
+	// Output clock
+	std::chrono::steady_clock::time_point m_start;
+	uint64_t m_tick = 0;
+
+	// Statistics
+	int64_t m_last_timestamp = NDIlib_recv_timestamp_undefined;
+	uint64_t m_held = 0;
+	uint64_t m_frames = 0;
+	uint64_t m_repeated = 0;
+	uint64_t m_dropped = 0;
+	uint64_t m_late = 0;
+};
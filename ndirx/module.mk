@@ -1,7 +1,7 @@
 local_dir  := $(subdirectory)
 local_pgm  := $(local_dir)/ndirx
 local_src  := $(wildcard $(local_dir)/*.cpp)
-local_objs := $(call src_to_obj, $(local_src) $(ndi_common))
+local_objs := $(call src_to_obj, $(local_src)) $(libndiutils)
 
 programs   += $(local_pgm)
 sources    += $(local_src)
@@ -13,132 +13,6 @@ FILE *dbgstream = stderr;
 int  debug_level = LOG_ERR;
 bool debug_flush = false;
 
-struct writer
-{
-	// Constructor and destructor
-	writer(NDIlib_recv_instance_t m_ndi_recv, FILE *outfile);
-	~writer(void);
-
-	// Start processing thread
-	void begin(void);
-
-	// Add a captured frame for processing
-	bool add_frame(NDIlib_video_frame_v2_t* frame);
-
-	// Finish processessing all queued frames
-	void flush(void);
-private:
-	// Process frames
-	void write_frames(void);
-
-	// NDI Receiver
-	NDIlib_recv_instance_t m_ndi_recv;
-
-	// Output file
-	FILE *m_outfile;
-
-	// Queue for NDI frames
-	queue<NDIlib_video_frame_v2_t> m_ndi_q;
-
-	// The processing thread
-	std::thread m_thread;
-};
-
-writer::writer(NDIlib_recv_instance_t ndi_recv, FILE *outfile)
-	: m_ndi_recv(ndi_recv), m_outfile(outfile)
-{
-	LOG(LOG_INFO, "writer Constructor\n");
-}
-
-writer::~writer(void)
-{
-	LOG(LOG_INFO, "writer Destructor\n");
-}
-
-void writer::begin(void)
-{
-	// Configure the queue to not drop any frames
-	m_ndi_q.set_depth(0);
-
-	// Start a thread to process frames
-	m_thread = std::thread(&writer::write_frames, this);
-}
-
-bool writer::add_frame(NDIlib_video_frame_v2_t* frame)
-{
-	// Bail if there is no data!
-	if ((frame) && (!frame->p_data))
-	{
-		LOG(LOG_WARN,"N");	// No data in NDI frame!
-		return true;
-	}
-
-	// Create a shared pointer we can pass along
-	std::shared_ptr<NDIlib_video_frame_v2_t> s_frame;
-
-	// If we were passed a valid frame, copy it into the shared pointer
-	// NULL is passed to indicate the decode thread should exit
-	if (frame)
-	{
-		s_frame = std::make_shared<NDIlib_video_frame_v2_t>(*frame);
-	}
-
-	// let's add it to the queue!
-	return m_ndi_q.push(s_frame);
-}
-
-void writer::flush(void)
-{
-	LOG(LOG_INFO, "Flushing %i elements from queue\n", m_ndi_q.get_depth());
-
-	// Submit an empty frame and wait for the thread to exit
-	add_frame(NULL);
-	m_thread.join();
-
-	LOG(LOG_INFO, "Queue flushed\n");
-}
-
-void writer::write_frames(void)
-{
-	pthread_setname_np(pthread_self(), "video_decode");
-	LOG(LOG_INFO, "writer thread\n");
-
-	// Local temporary variable to hold details of a compressed frame
-	std::shared_ptr<NDIlib_video_frame_v2_t> video_frame;
-
-	// Cycle forever, exit when we get sent an empty frame
-	while (true)
-	{
-		// Get a frame to process from the queue
-		video_frame = m_ndi_q.pop();
-
-		// Indicate frame "popped" from the queue
-		LOG(LOG_DBG, "p");	// Popped video frame from NDI queue
-
-		// An empty frame is submitted as a signal to exit the thread
-		if (!video_frame) break;
-
-		// Calculate expected line stride and frame size
-		int line_stride =  video_frame->xres * sizeof(uint16_t);
-		size_t frame_size = line_stride * video_frame->yres * 2;
-
-		// Sanity check, we don't currently handle non-packed line stride
-		if (line_stride != video_frame->line_stride_in_bytes) {
-			LOG(LOG_ERR, "%i:%i\n", line_stride, video_frame->line_stride_in_bytes);
-			throw std::runtime_error("Unsupported line stride!");
-		}
-
-		// Write video data
-		size_t wlen = fwrite(video_frame->p_data, 1, frame_size, m_outfile);
-		if (wlen != frame_size) {
-			throw std::runtime_error("Something went wrong writing the output file!\n");
-		}
-
-		// Free the video data
-		NDIlib_recv_free_video_v2(m_ndi_recv, video_frame.get());
-	}
-}
-
 void boilerplate()
 {
 	// Report the NDI SDK Version
@@ -159,16 +33,51 @@ int main(int argc, char* argv[])
 	// Default output file
 	FILE *outfile = stdout;
 
+	// Optional striped output, the output file is then the manifest
+	std::vector<std::string> stripes;
+
+	// Optional cropped outputs
+	std::vector<crop_spec> crops;
+
 	// Number of frames to record
 	int num_frames = -1;
 
+	// Optional per-frame hash log
+	FILE *hashfile = NULL;
+
+	// Optional audio output and A/V timestamp log
+	FILE *audiofile = NULL;
+	FILE *tsfile = NULL;
+
+	// Optional timing sidecar
+	FILE *timingfile = NULL;
+
+	// Optional pipeline trace
+	FILE *tracefile = NULL;
+
+	// Optional transport and network adapter selection
+	const char* transport = NULL;
+	const char* adapters = NULL;
+
+	// Report receive performance
+	bool bench = false;
+
+	// Optional constant output frame rate
+	int sync_rate_n = 0;
+	int sync_rate_d = 1;
+
+	// Optional downscaled proxy output
+	FILE *proxyfile = NULL;
+	int proxy_scale = 4;
+	int proxy_divisor = 1;
+
 	debug_flush = false;
 
 	int temp;
 
 	// Passed on the command line
 	int opt;
-	while ((opt = getopt(argc, argv, "s:o:c:vqf")) != -1) {
+	while ((opt = getopt(argc, argv, "s:o:S:C:a:A:c:F:H:T:j:t:N:p:d:D:Bvqf")) != -1) {
 		switch (opt) {
 		// NDI Source
 		case 's':
@@ -185,12 +94,111 @@ int main(int argc, char* argv[])
 			}
 			break;
 
+		// Stripe files or directories
+		case 'S':
+			stripes = split_list(optarg);
+			break;
+
+		// Cropped output
+		case 'C':
+			crops.emplace_back();
+			if (!parse_crop(optarg, &crops.back())) {
+				fprintf (stderr, "Invalid crop %s, expected x,y,w,h:file with even x and w!\n", optarg);
+				abort();
+			}
+			break;
+
+		// Audio output file
+		case 'a':
+			audiofile = fopen(optarg, "wb");
+			if (audiofile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
+			break;
+
+		// A/V timestamp log
+		case 'A':
+			tsfile = fopen(optarg, "w");
+			if (tsfile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
+			break;
+
 		// Frame count
 		case 'c':
 			temp = strtol(optarg, NULL, 0);
 			if (temp > 0) num_frames = temp;
 			break;
 
+		// Constant output frame rate
+		case 'F':
+			arg2rate(optarg, &sync_rate_n, &sync_rate_d);
+			break;
+
+		// Hash log file
+		case 'H':
+			hashfile = fopen(optarg, "w");
+			if (hashfile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
+			break;
+
+		// Timing sidecar file
+		case 'T':
+			timingfile = fopen(optarg, "wb");
+			if (timingfile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
+			break;
+
+		// Trace file
+		case 'j':
+			tracefile = fopen(optarg, "w");
+			if (tracefile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
+			break;
+
+		// Transport
+		case 't':
+			transport = optarg;
+			break;
+
+		// Network adapters
+		case 'N':
+			adapters = optarg;
+			break;
+
+		// Benchmark
+		case 'B':
+			bench = true;
+			break;
+
+		// Proxy output file
+		case 'p':
+			proxyfile = fopen(optarg, "wb");
+			if (proxyfile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
+			break;
+
+		// Proxy downscale factor
+		case 'd':
+			proxy_scale = strtol(optarg, NULL, 0);
+			break;
+
+		// Proxy frame rate divisor
+		case 'D':
+			temp = strtol(optarg, NULL, 0);
+			if (temp > 0) proxy_divisor = temp;
+			break;
+
 		// Debugging
 		case 'v':	// Increase debugging level
 			debug_level++;
@@ -203,10 +211,24 @@ int main(int argc, char* argv[])
 			break;
 
 		default:	// '?'
-			fprintf(stderr, "Usage: %s [-s <NDI Source>] [-o <filename>] [-c <framecount>] [-vqf]\n", argv[0]);
+			fprintf(stderr, "Usage: %s [-s <NDI Source>] [-o <filename> [-S <stripe>,<stripe>...]] [-C <x,y,w,h:file> ...] [-a <audio file>] [-A <timestamp log>] [-c <framecount>] [-F <framerate-n[/framerate-d]>] [-H <hashlog>] [-T <timing file>] [-j <trace file>] [-t <transport>] [-N <adapter[,adapter...]>] [-B] [-p <proxy file> [-d <scale>] [-D <divisor>]] [-vqf]\n", argv[0]);
 			fprintf(stderr, "  -s Specify NDI source to display\n");
 			fprintf(stderr, "  -o Specify output filename (default is to use stdout)\n");
+			fprintf(stderr, "  -S Write frames across these files or directories (eg: on separate drives), -o names the manifest\n");
+			fprintf(stderr, "  -C Also write a w x h window at x,y to a separate file, may be repeated (x and w must be even)\n");
+			fprintf(stderr, "  -a Also record audio as a 32-bit PCM WAV file\n");
+			fprintf(stderr, "  -A Log the timestamp of every video frame and audio block written\n");
 			fprintf(stderr, "  -c Frame count or number of frames to record (default: Wait for user input)\n");
+			fprintf(stderr, "  -F Output frames at exactly this rate, repeating or dropping frames as needed\n");
+			fprintf(stderr, "  -H Write a hash of each received frame to the specified file\n");
+			fprintf(stderr, "  -T Write the receive time, timestamp, and timecode of each frame to a binary timing file for nditx -R\n");
+			fprintf(stderr, "  -j Write a Chrome trace of per-frame events at exit or on SIGUSR1 (open with Perfetto)\n");
+			fprintf(stderr, "  -t Only receive using this transport: %s (default: any)\n", transport_names());
+			fprintf(stderr, "  -N Only use the network adapters with these IP addresses\n");
+			fprintf(stderr, "  -B Report CPU time per frame, throughput, and dropped frames at exit\n");
+			fprintf(stderr, "  -p Also write a downscaled P216 proxy to the specified file or pipe\n");
+			fprintf(stderr, "  -d Proxy downscale factor: 2, 4, or 8 (default: 4)\n");
+			fprintf(stderr, "  -D Proxy frame rate divisor, write every Nth frame (default: 1)\n");
 			fprintf(stderr, "  -v Increase debugging output level\n");
 			fprintf(stderr, "  -q Decrease debugging output level\n");
 			fprintf(stderr, "  -f fflush() after each debug message\n");
@@ -215,6 +237,30 @@ int main(int argc, char* argv[])
 	}
 
 	// Check for conflicting options
+	if ((sync_rate_n < 0) || (sync_rate_d <= 0)) {
+		LOG(LOG_ERR, "ERROR: Invalid frame sync rate!\n");
+		exit(EXIT_FAILURE);
+	}
+	if (sync_rate_n && audiofile) {
+		LOG(LOG_ERR, "ERROR: Audio recording is not supported with a constant frame rate!\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (!stripes.empty() && (outfile == stdout)) {
+		LOG(LOG_ERR, "ERROR: Striped output needs a manifest file (-o)!\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (transport && !is_transport(transport)) {
+		LOG(LOG_ERR, "ERROR: Unknown transport %s, try: %s\n", transport, transport_names());
+		exit(EXIT_FAILURE);
+	}
+
+	if ((proxy_scale != 2) && (proxy_scale != 4) && (proxy_scale != 8)) {
+		LOG(LOG_ERR, "ERROR: Proxy scale must be 2, 4, or 8!\n");
+		exit(EXIT_FAILURE);
+	}
+
 	if ((num_frames == 0) && (interactive == false)) {
 		LOG(LOG_ERR, "ERROR: Number of frames to record was not specified and stdin is not a tty!\n");
 		exit(EXIT_FAILURE);
@@ -232,159 +278,228 @@ int main(int argc, char* argv[])
 	// Not required, but "correct" (see the SDK documentation.
 	if (!NDIlib_initialize()) throw std::runtime_error("Cannot run NDI!");
 
-	// NDI Finder instance, if needed
-	NDIlib_find_instance_t pNDI_find = NULL;
-
 	// The user didn't request a particular NDI source, just use the
 	// first one we find
-	if (ndi_source.p_ndi_name) {
-		// Just use the specified NDI source
-	} else {
-		// We need to look for a source...
-
-		// Create a finder instance
-		pNDI_find = NDIlib_find_create_v2();
-		if (!pNDI_find) throw std::runtime_error("Cannot create NDI finder!");
-
-		uint32_t num_sources = 0;
-		const NDIlib_source_t* p_sources = NULL;
-
-		// Wait until there is at least one source
-		while (!num_sources)
-		{	// Wait until the sources on the network have changed
-			LOG(LOG_INFO, "Looking for sources ...\n");
-			NDIlib_find_wait_for_sources(pNDI_find, 1000/* One second */);
-			p_sources = NDIlib_find_get_current_sources(pNDI_find, &num_sources);
-		}
-
-		LOG(LOG_INFO, "Found %u sources\n", num_sources);
-
-		// Use the first source found
-		ndi_source = p_sources[0];
+	finder *my_finder = NULL;
+	if (!ndi_source.p_ndi_name) {
+		my_finder = new finder();
+		ndi_source = *my_finder->wait_for_first_source();
 	}
 
 	LOG(LOG_INFO, "Using source %s\n", ndi_source.p_ndi_name);
 
-	// Configure our receiver settings
-	NDIlib_recv_create_v3_t my_settings;
-	my_settings.source_to_connect_to = NULL; // Specified later
-	my_settings.color_format = (NDIlib_recv_color_format_e) NDIlib_recv_color_format_best;
-	my_settings.bandwidth = NDIlib_recv_bandwidth_highest;
-	my_settings.allow_video_fields = true;
-	my_settings.p_ndi_recv_name = "ndirx";
+	// Create an NDI receiver and connect to our source
+	receiver *my_recv = new receiver(ndi_source, make_recv_config(transport, adapters));
 
-	// Create a JSON configuration string we can pass to the NDI library
-	// These configuration settings can also be done using a file
-	// See "Configuration Files" in the SDK documentation for details
-
-	// Opening stanza
-	std::string ndi_config;
-	ndi_config = R"({ "ndi": { )";
+	// We can now destroy the NDI finder if we created one...
+	// ...we no longer need access to ndi_source
+	if (my_finder) delete my_finder;
 
-	// Without a valid vendor ID, the Embedded NDI stack runs in demo mode for 30 minutes
-	// If you have a valid vendor ID, add it below, eg:
-	// ndi_config.append( R"("vendor": { "name": "My Company", "id": "00000000000000000000000000000000000000000000", } )";
+	// Start tracing before any of our threads start
+	if (tracefile) trace_begin(tracefile);
 
-	// Examples of specifying connection settings, uncomment if desired:
+	// Create a writer class to disconnect write performance from
+	// NDI receiving performance
+	timestamp_log *my_ts_log = NULL;
+	if (tsfile) my_ts_log = new timestamp_log(tsfile);
+
+	// Write to a single output, or across several stripes
+	// With crops and no output file only the crops are written
+	writer *my_writer = NULL;
+	striped_writer *my_stripes = NULL;
+	if (!crops.empty() && (outfile == stdout)) {
+		// No full frame output
+	} else if (stripes.empty()) {
+		my_writer = new writer(outfile, my_ts_log);
+		my_writer->begin();
+	} else {
+		my_stripes = new striped_writer(outfile, stripes, my_ts_log);
+		my_stripes->begin();
+	}
 
-	// Explicitly enable mTCP and UDP formats
-	// ndi_config.append( R"(
-	// 	"tcp": { "recv": { "enable": true } },
-	// 	"unicast": { "recv": { "enable": true } },
-	// 	"rudp": { "recv": { "enable": true } } )" );
+	// Each crop has its own write thread
+	std::vector<FILE*> crop_files;
+	std::vector<crop_writer*> crop_writers;
+	for (auto& c : crops) {
+		FILE *cropfile = fopen(c.path.c_str(), "wb");
+		if (cropfile == NULL) {
+			LOG(LOG_ERR, "Cannot open %s for writing!\n", c.path.c_str());
+			exit(EXIT_FAILURE);
+		}
+		crop_files.push_back(cropfile);
+		crop_writers.push_back(new crop_writer(cropfile, c));
+		crop_writers.back()->begin();
+	}
 
-	// Disable mTCP and UDP formats which use a *LOT* of CPU on lower end platforms (eg: 32-bit ARM)
-	// ndi_config.append( R"(
-	// 	"tcp": { "recv": { "enable": false } },
-	// 	"unicast": { "recv": { "enable": false } },
-	// 	"rudp": { "recv": { "enable": false } } )" );
+	// Audio has its own queue and write thread so audio and video never
+	// hold each other up
+	audio_writer *my_audio = NULL;
+	if (audiofile) {
+		my_audio = new audio_writer(audiofile, my_ts_log);
+		my_audio->begin();
+	}
 
-	// ndi_config.append( R"( "adapters": { "allowed": ["10.34.1.11"] } )" );
+	// Hash frames on separate threads so writing is never held up
+	hasher *my_hasher = NULL;
+	if (hashfile) {
+		my_hasher = new hasher(hashfile);
+		my_hasher->begin();
+	}
 
-	// Closing braces
-	ndi_config.append( R"(} })" );
+	// Downscale frames on a separate thread, skipping frames if it falls behind
+	proxy *my_proxy = NULL;
+	if (proxyfile) {
+		my_proxy = new proxy(proxyfile, proxy_scale, proxy_divisor);
+		my_proxy->begin();
+	}
 
-	LOG(LOG_INFO, "ndi_config: %s\n",  ndi_config.c_str());
+	// Record from the receiver, passing every output frame to the outputs
+	recorder my_rec(my_recv);
 
-	// Create an NDI receiver
-	NDIlib_recv_instance_t ndi_recv = NDIlib_recv_create_v4(&my_settings, ndi_config.c_str());
-	if (!ndi_recv) throw std::runtime_error("Cannot create NDI Receiver!");
+	// Pace the output with the frame synchronizer
+	frame_sync *my_sync = NULL;
+	if (sync_rate_n) {
+		my_sync = new frame_sync(my_recv->get_instance(), sync_rate_n, sync_rate_d);
+		my_rec.set_paced_source([my_sync](std::shared_ptr<NDIlib_video_frame_v2_t>* frame, int* copies) {
+			*frame = my_sync->capture(copies);
 
-	// Connect to our sources
-	LOG(LOG_INFO, "Connecting to %s\n", ndi_source.p_ndi_name);
-	NDIlib_recv_connect(ndi_recv, &ndi_source);
+			// If the sender has been repeating the same frame for a few
+			// seconds it probably went away, exit cleanly
+			return my_sync->get_held_time() < 5.0;
+		}, sync_rate_n, sync_rate_d);
+	}
 
-	// We can now destroy the NDI finder if we created one...
-	// ...we no longer need access to ndi_source (aka: p_sources[0])
-	if (pNDI_find) NDIlib_find_destroy(pNDI_find);
+	// Measure the cost of receiving
+	benchmark *my_bench = NULL;
+	if (bench) {
+		my_bench = new benchmark(my_recv->get_instance(), transport);
+		my_rec.on_receive([my_bench](std::shared_ptr<NDIlib_video_frame_v2_t> frame) {
+			my_bench->add_frame(frame->xres * sizeof(uint16_t) * frame->yres * 2);
+		});
+	}
 
-	// Create a writer class to disconnect write performance from
-	// NDI receiving performance
-	writer *my_writer = new writer(ndi_recv, outfile);
+	// Record the receive timing of every frame written
+	timing_writer *my_timing = NULL;
+	if (timingfile) my_timing = new timing_writer(timingfile);
 
-	// Start the write thread
-	my_writer->begin();
+	// Frames are shared between the outputs
+	if (my_audio) {
+		my_rec.set_audio_output([my_audio](std::shared_ptr<NDIlib_audio_frame_v3_t> frame) {
+			my_audio->add_frame(frame);
+		});
+	}
+	if (!crop_writers.empty()) {
+		// Check the crops on this thread before any output takes the frame,
+		// stopping cleanly so every output is complete
+		my_rec.add_output([&crop_writers, &my_rec](std::shared_ptr<NDIlib_video_frame_v2_t> frame, uint64_t, uint64_t) {
+			for (auto c : crop_writers) {
+				if (!c->fits(*frame)) my_rec.stop();
+			}
+		});
+	}
+	if (my_stripes) {
+		// Stripes come before the other outputs so a frame they reject goes
+		// nowhere, then stop so the manifest covers every frame written
+		my_rec.add_output([my_stripes, &my_rec](std::shared_ptr<NDIlib_video_frame_v2_t> frame, uint64_t, uint64_t) {
+			if (!my_stripes->add_frame(frame)) my_rec.stop();
+		});
+	}
+	if (my_hasher) {
+		// Hash the same packed P216 payload the writer sends to the output
+		my_rec.add_output([my_hasher](std::shared_ptr<NDIlib_video_frame_v2_t> frame, uint64_t, uint64_t) {
+			size_t frame_size = frame->xres * sizeof(uint16_t) * frame->yres * 2;
+			my_hasher->add_frame(frame, frame->p_data, frame_size);
+		});
+	}
+	if (my_proxy) {
+		my_rec.add_output([my_proxy](std::shared_ptr<NDIlib_video_frame_v2_t> frame, uint64_t, uint64_t) {
+			my_proxy->add_frame(frame);
+		});
+	}
+	if (my_writer) {
+		my_rec.add_output([my_writer](std::shared_ptr<NDIlib_video_frame_v2_t> frame, uint64_t, uint64_t) {
+			my_writer->add_frame(frame);
+		});
+	}
+	for (auto c : crop_writers) {
+		my_rec.add_output([c](std::shared_ptr<NDIlib_video_frame_v2_t> frame, uint64_t, uint64_t) {
+			c->add_frame(frame);
+		});
+	}
+	if (my_timing) {
+		my_rec.add_output([my_timing](std::shared_ptr<NDIlib_video_frame_v2_t> frame, uint64_t, uint64_t due_ns) {
+			my_timing->add_frame(due_ns, frame->timestamp, frame->timecode);
+		});
+	}
 
-	// Setup to poll stdin to see if read data is available
-	pollfd fds[1];
-	fds[0].fd = STDIN_FILENO;
-	fds[0].events = POLLIN;
-	fds[0].revents = 0;
+	my_rec.run(num_frames, interactive);
 
-	bool active = false;
-	int delay = 0;
+	// Wait for all the writes to finish
+	LOG(LOG_INFO, "Flushing write queue\n");
+	if (my_writer) {
+		my_writer->flush();
+		delete my_writer;
+	}
+	if (my_stripes) {
+		my_stripes->flush();
+		delete my_stripes;
+	}
+	for (size_t i=0; i<crop_writers.size(); i++) {
+		crop_writers[i]->flush();
+		delete crop_writers[i];
+		fclose(crop_files[i]);
+	}
 
-	while (num_frames != 0)
-	{
-		// Check for user abort (data available on stdin)
-		if (interactive && (poll(fds, 1, 0) != 0)) {
-			break;
-		}
+	// Wait for all the audio to be written
+	if (my_audio) {
+		my_audio->flush();
+		delete my_audio;
+		fclose(audiofile);
+	}
 
-		// Keep tabs on our performance
-		NDIlib_recv_queue_t recv_q;
-		NDIlib_recv_get_queue(ndi_recv, &recv_q);
-		LOG(LOG_INFO, "q%i", recv_q.video_frames);
+	if (my_timing) {
+		delete my_timing;
+		fclose(timingfile);
+	}
 
-		// Wait for up to 1 second to see if there are any frames available
-		NDIlib_frame_type_e frame_type;
-		NDIlib_video_frame_v2_t video_frame;
+	if (my_ts_log) {
+		delete my_ts_log;
+		fclose(tsfile);
+	}
 
-		frame_type = NDIlib_recv_capture_v3(ndi_recv, &video_frame, NULL, NULL, 1000);
-		if (frame_type == NDIlib_frame_type_video) {
-			// Received a video frame
-			LOG(LOG_INFO, ".");
-			active = true;
+	// Wait for all the hashes to be logged
+	if (my_hasher) {
+		my_hasher->flush();
+		delete my_hasher;
+		fclose(hashfile);
+	}
 
-			// Make sure it's the format we expect!
-			if (video_frame.FourCC != NDIlib_FourCC_type_P216) {
-				throw std::runtime_error("Unexpected video format!");
-			}
+	// Wait for the last proxy frame
+	if (my_proxy) {
+		my_proxy->flush();
+		delete my_proxy;
+		fclose(proxyfile);
+	}
 
-			// Add the frame to the write queue
-			my_writer->add_frame(&video_frame);
-
-			// Keep going until we're finished
-			if (num_frames > 0) num_frames--;
-		} else if (frame_type == NDIlib_frame_type_none) {
-			if (active) {
-				// We were seeing video frames, but not any more
-				// Our sender probably went away, give it a few
-				// seconds and then exit cleanly
-				if (delay++ >= 5) num_frames = 0;
-			}
-		}
+	// All frames have been released, we can destroy the frame synchronizer
+	if (my_sync) {
+		my_sync->report();
+		delete my_sync;
 	}
 
-	// Wait for all the writes to finish
-	LOG(LOG_INFO, "Flushing write queue\n");
-	my_writer->flush();
+	if (my_bench) {
+		my_bench->report();
+		delete my_bench;
+	}
 
-	// Destroy the writer
-	delete my_writer;
+	// Every frame has been written and freed
+	if (tracefile) {
+		trace_end();
+		fclose(tracefile);
+	}
 
 	// Destroy the receiver
-	NDIlib_recv_destroy(ndi_recv);
+	delete my_recv;
 
 	// Not required, but nice
 	NDIlib_destroy();
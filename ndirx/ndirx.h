@@ -5,12 +5,28 @@
 
 #pragma once
 
-// Debug logging
-#include "../ndi_common/debug.h"
+// NDI receiving and shared utilities
+#include "../libndiutils/ndiutils.h"
 
-// NDI library
-#include <Processing.NDI.Lib.h>
-#include <Processing.NDI.Advanced.h>
+// Frame hashing
+#include "../ndi_common/hash.h"
 
-// Queue class
-#include "../ndi_common/queue.h"
+// Downscaled proxy output
+#include "proxy.h"
+
+// Constant rate output
+#include "framesync.h"
+
+// Audio conversion and output
+#include "../ndi_common/audio.h"
+#include "../ndi_common/timestamp_log.h"
+#include "audio_writer.h"
+
+// Receive benchmark
+#include "benchmark.h"
+
+// Multi-file output
+#include "striped_writer.h"
+
+// Cropped outputs
+#include "crop_writer.h"
@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndirx.h"
+
+// Box filter one plane by SCALE in both directions.  Source lines are summed
+// into a row of accumulators first, then groups of samples are summed across
+// the row.  interleave is 1 for the Y plane and 2 for the UV plane, where
+// the U and V samples of neighbouring pairs are averaged separately.  The
+// scale is a template parameter so the inner loops vectorize.
+template <int SCALE, int INTERLEAVE>
+static void downscale_plane(const uint8_t* src, int src_stride, int src_width,
+	uint16_t* dst, int dst_width, int dst_height, std::vector<uint32_t>& acc)
+{
+	const int shift = (SCALE == 2) ? 2 : (SCALE == 4) ? 4 : 6;
+	const uint32_t round = 1 << (shift - 1);
+	acc.resize(src_width);
+
+	for (int y=0; y<dst_height; y++) {
+		// Vertical sum
+		const uint16_t* line = (const uint16_t*)(src + (size_t)y * SCALE * src_stride);
+		for (int x=0; x<src_width; x++) acc[x] = line[x];
+
+		for (int k=1; k<SCALE; k++) {
+			line = (const uint16_t*)(src + ((size_t)y * SCALE + k) * src_stride);
+			for (int x=0; x<src_width; x++) acc[x] += line[x];
+		}
+
+		// Horizontal sum
+		uint16_t* out = dst + (size_t)y * dst_width;
+		for (int x=0; x<dst_width; x+=INTERLEAVE) {
+			for (int c=0; c<INTERLEAVE; c++) {
+				const uint32_t* a = &acc[x * SCALE + c];
+				uint32_t sum = 0;
+				for (int k=0; k<SCALE; k++) sum += a[k * INTERLEAVE];
+				out[x + c] = (uint16_t)((sum + round) >> shift);
+			}
+		}
+	}
+}
+
+template <int SCALE>
+static void downscale_frame(const NDIlib_video_frame_v2_t* frame, std::vector<uint16_t>& buffer,
+	int dst_xres, int dst_yres)
+{
+	std::vector<uint32_t> acc;
+	int stride = frame->line_stride_in_bytes;
+	const uint8_t* y_plane = frame->p_data;
+	const uint8_t* uv_plane = frame->p_data + (size_t)stride * frame->yres;
+
+	uint16_t* dst_y = buffer.data();
+	uint16_t* dst_uv = dst_y + (size_t)dst_xres * dst_yres;
+
+	downscale_plane<SCALE, 1>(y_plane, stride, dst_xres * SCALE, dst_y, dst_xres, dst_yres, acc);
+	downscale_plane<SCALE, 2>(uv_plane, stride, dst_xres * SCALE, dst_uv, dst_xres, dst_yres, acc);
+}
+
+proxy::proxy(FILE *outfile, int scale, int rate_divisor)
+	: m_outfile(outfile), m_scale(scale), m_rate_divisor(rate_divisor)
+{
+	LOG(LOG_INFO, "proxy Constructor\n");
+
+	if ((scale != 2) && (scale != 4) && (scale != 8)) {
+		throw std::runtime_error("Proxy scale must be 2, 4, or 8!");
+	}
+
+	if (m_rate_divisor < 1) m_rate_divisor = 1;
+}
+
+proxy::~proxy(void)
+{
+	LOG(LOG_INFO, "proxy Destructor\n");
+}
+
+void proxy::begin(void)
+{
+	// Frames are skipped in add_frame rather than dropped by the queue
+	m_ndi_q.set_depth(0);
+
+	// Start a thread to process frames
+	m_thread = std::thread(&proxy::write_frames, this);
+}
+
+void proxy::add_frame(std::shared_ptr<NDIlib_video_frame_v2_t> frame)
+{
+	// Only every m_rate_divisor'th frame goes to the proxy
+	if ((m_frames_offered++ % m_rate_divisor) != 0) return;
+
+	// Skip the frame if the proxy thread hasn't caught up yet
+	if (m_ndi_q.get_depth() > 0) {
+		m_frames_dropped++;
+		LOG(LOG_INFO, "d");	// Dropped a proxy frame
+		return;
+	}
+
+	m_ndi_q.push(frame);
+}
+
+void proxy::flush(void)
+{
+	LOG(LOG_INFO, "Flushing %i elements from proxy queue\n", m_ndi_q.get_depth());
+
+	// Submit an empty frame and wait for the thread to exit
+	m_ndi_q.push(NULL);
+	m_thread.join();
+
+	fflush(m_outfile);
+
+	LOG(LOG_WARN, "Proxy dropped %llu frames\n", (unsigned long long)m_frames_dropped);
+}
+
+void proxy::write_frames(void)
+{
+	pthread_setname_np(pthread_self(), "video_proxy");
+	LOG(LOG_INFO, "proxy thread\n");
+
+	std::shared_ptr<NDIlib_video_frame_v2_t> video_frame;
+	int xres = 0;
+	int yres = 0;
+
+	// Cycle forever, exit when we get sent an empty frame
+	while (true)
+	{
+		video_frame = m_ndi_q.pop();
+
+		// An empty frame is submitted as a signal to exit the thread
+		if (!video_frame) break;
+
+		// Proxy resolution, chroma needs an even width
+		int dst_xres = (video_frame->xres / m_scale) & ~1;
+		int dst_yres = video_frame->yres / m_scale;
+		if ((dst_xres != xres) || (dst_yres != yres)) {
+			xres = dst_xres;
+			yres = dst_yres;
+			LOG(LOG_WARN, "Proxy resolution %ix%i\n", xres, yres);
+			m_buffer.resize((size_t)xres * yres * 2);
+		}
+		if (!xres || !yres) continue;
+
+		switch (m_scale) {
+		case 2: downscale_frame<2>(video_frame.get(), m_buffer, xres, yres); break;
+		case 4: downscale_frame<4>(video_frame.get(), m_buffer, xres, yres); break;
+		case 8: downscale_frame<8>(video_frame.get(), m_buffer, xres, yres); break;
+		}
+
+		// Done with the full resolution frame
+		video_frame.reset();
+
+		// Write video data
+		size_t frame_size = m_buffer.size() * sizeof(uint16_t);
+		size_t wlen = fwrite(m_buffer.data(), 1, frame_size, m_outfile);
+		if (wlen != frame_size) {
+			throw std::runtime_error("Something went wrong writing the proxy file!\n");
+		}
+	}
+}
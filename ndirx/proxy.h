@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Writes a box filtered, downscaled P216 copy of the received frames on its
+// own thread.  The proxy is strictly best effort: if the thread is still busy
+// when a new frame arrives the frame is skipped, so the proxy can never hold
+// up receiving or the full resolution writer.
+struct proxy
+{
+	// Constructor and destructor
+	// scale must be 2, 4, or 8
+	proxy(FILE *outfile, int scale, int rate_divisor);
+	~proxy(void);
+
+	// Start processing thread
+	void begin(void);
+
+	// Offer a captured frame for the proxy
+	void add_frame(std::shared_ptr<NDIlib_video_frame_v2_t> frame);
+
+	// Finish processessing all queued frames
+	void flush(void);
+private:
+	// Process frames
+	void write_frames(void);
+
+	// Output file
+	FILE *m_outfile;
+
+	// Downscale factor and frame rate divisor
+	int m_scale;
+	int m_rate_divisor;
+
+	// Statistics
+	uint64_t m_frames_offered = 0;
+	uint64_t m_frames_dropped = 0;
+
+	// Downscaled frame
+	std::vector<uint16_t> m_buffer;
+
+	// Queue for NDI frames
+	queue<NDIlib_video_frame_v2_t> m_ndi_q;
+
+	// The processing thread
+	std::thread m_thread;
+};
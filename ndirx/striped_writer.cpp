@@ -0,0 +1,210 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndirx.h"
+
+#include <cinttypes>
+#include <climits>
+#include <cstdlib>
+
+#include <sys/stat.h>
+
+striped_writer::striped_writer(FILE *manifest, const std::vector<std::string>& paths, timestamp_log* ts_log, int max_pending)
+	: m_manifest(manifest), m_ts_log(ts_log), m_max_pending(max_pending)
+{
+	LOG(LOG_INFO, "striped_writer Constructor\n");
+
+	for (size_t i=0; i<paths.size(); i++) {
+		std::unique_ptr<stripe> s(new stripe);
+		s->path = paths[i];
+
+		// Put a stripe file inside directories
+		struct stat st;
+		if ((stat(s->path.c_str(), &st) == 0) && S_ISDIR(st.st_mode)) {
+			char name[64];
+			snprintf(name, sizeof(name), "/ndirx.stripe%02zu.p216", i);
+			s->path += name;
+		}
+
+		s->outfile = fopen(s->path.c_str(), "wb");
+		if (s->outfile == NULL) {
+			LOG(LOG_ERR, "Cannot open %s for writing!\n", s->path.c_str());
+			throw std::runtime_error("Cannot open stripe file!");
+		}
+
+		// Frames are large, write them straight from the NDI buffer
+		setvbuf(s->outfile, NULL, _IONBF, 0);
+
+		std::string idx_path = s->path + ".idx";
+		s->idxfile = fopen(idx_path.c_str(), "w");
+		if (s->idxfile == NULL) {
+			LOG(LOG_ERR, "Cannot open %s for writing!\n", idx_path.c_str());
+			throw std::runtime_error("Cannot open stripe index file!");
+		}
+
+		// The manifest may be read from another directory
+		char abs_path[PATH_MAX];
+		if (realpath(s->path.c_str(), abs_path)) s->path = abs_path;
+
+		m_stripes.push_back(std::move(s));
+	}
+}
+
+striped_writer::~striped_writer(void)
+{
+	LOG(LOG_INFO, "striped_writer Destructor\n");
+
+	for (auto& s : m_stripes) {
+		fclose(s->outfile);
+		fclose(s->idxfile);
+	}
+}
+
+void striped_writer::begin(void)
+{
+	for (auto& s : m_stripes) {
+		// Configure the queue to not drop any frames, the pending count
+		// limits the depth
+		s->job_q.set_depth(0);
+
+		// Start a thread to write frames
+		s->thread = std::thread(&striped_writer::write_frames, this, s.get());
+	}
+}
+
+bool striped_writer::add_frame(std::shared_ptr<NDIlib_video_frame_v2_t> frame)
+{
+	// Bail if there is no data!
+	if (!frame->p_data)
+	{
+		LOG(LOG_WARN,"N");	// No data in NDI frame!
+		return true;
+	}
+
+	// Every frame must be the same size so the stripes can be reassembled
+	// The frames already written still are, so the frame is dropped rather
+	// than throwing on the receive thread and losing the manifest
+	if (!m_frames) {
+		m_xres = frame->xres;
+		m_yres = frame->yres;
+	} else if ((frame->xres != m_xres) || (frame->yres != m_yres)) {
+		LOG(LOG_ERR, "Resolution changed from %ix%i to %ix%i, which is not supported with striped output!\n",
+			m_xres, m_yres, frame->xres, frame->yres);
+		return false;
+	}
+
+	std::shared_ptr<job> s_job = std::make_shared<job>();
+	s_job->index = m_frames++;
+	s_job->frame = frame;
+
+	stripe* target;
+	{
+		std::unique_lock<std::mutex> lock_pending(m_lock);
+
+		while (true) {
+			// Pick the stripe with the fewest pending frames, starting
+			// after the last one used so equally loaded stripes are used
+			// round-robin
+			size_t best = m_next_stripe % m_stripes.size();
+			for (size_t i=1; i<m_stripes.size(); i++) {
+				size_t n = (m_next_stripe + i) % m_stripes.size();
+				if (m_stripes[n]->pending < m_stripes[best]->pending) best = n;
+			}
+			target = m_stripes[best].get();
+
+			if (target->pending < m_max_pending) {
+				m_next_stripe = best + 1;
+				break;
+			}
+
+			// Every stripe is behind, wait for one to finish a frame
+			LOG(LOG_DBG, "W");
+			m_condvar.wait(lock_pending);
+		}
+
+		target->pending++;
+	}
+
+	target->job_q.push(s_job);
+
+	return true;
+}
+
+void striped_writer::flush(void)
+{
+	LOG(LOG_INFO, "Flushing striped writer\n");
+
+	// Submit an empty job to each stripe and wait for them to exit
+	for (auto& s : m_stripes) {
+		s->job_q.push(NULL);
+	}
+	for (auto& s : m_stripes) {
+		s->thread.join();
+	}
+
+	// Write the manifest now the frame count is known
+	fprintf(m_manifest, "size %i %i\n", m_xres, m_yres);
+	fprintf(m_manifest, "frames %" PRIu64 "\n", m_frames);
+	for (auto& s : m_stripes) {
+		fprintf(m_manifest, "stripe %s\n", s->path.c_str());
+	}
+	fflush(m_manifest);
+
+	LOG(LOG_INFO, "Striped writer flushed\n");
+}
+
+void striped_writer::write_frames(stripe* s)
+{
+	pthread_setname_np(pthread_self(), "stripe_write");
+	LOG(LOG_INFO, "striped_writer thread\n");
+
+	std::shared_ptr<job> frame_job;
+
+	// Cycle forever, exit when we get sent an empty job
+	while (true)
+	{
+		frame_job = s->job_q.pop();
+
+		// An empty job is submitted as a signal to exit the thread
+		if (!frame_job) break;
+		trace_event("popped", frame_job->index);
+
+		NDIlib_video_frame_v2_t* video_frame = frame_job->frame.get();
+
+		// Calculate expected line stride and frame size
+		int line_stride =  video_frame->xres * sizeof(uint16_t);
+		size_t frame_size = line_stride * video_frame->yres * 2;
+
+		// Sanity check, we don't currently handle non-packed line stride
+		if (line_stride != video_frame->line_stride_in_bytes) {
+			LOG(LOG_ERR, "%i:%i\n", line_stride, video_frame->line_stride_in_bytes);
+			throw std::runtime_error("Unsupported line stride!");
+		}
+
+		// Write video data
+		{
+			trace_span span("write", frame_job->index);
+			size_t wlen = fwrite(video_frame->p_data, 1, frame_size, s->outfile);
+			if (wlen != frame_size) {
+				throw std::runtime_error("Something went wrong writing a stripe file!\n");
+			}
+		}
+		fprintf(s->idxfile, "%" PRIu64 "\n", frame_job->index);
+
+		if (m_ts_log) m_ts_log->video(frame_job->index, video_frame->timestamp, video_frame->timecode);
+
+		// Release our reference, the video data is freed once every
+		// consumer of the frame is done with it
+		frame_job.reset();
+
+		// Let the receive thread know this stripe has room
+		{
+			std::unique_lock<std::mutex> lock_pending(m_lock);
+			s->pending--;
+		}
+		m_condvar.notify_one();
+	}
+}
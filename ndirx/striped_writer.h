@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Writes frames across several output files (stripes), typically on separate
+// drives, with one write thread per stripe so the combined write bandwidth
+// can keep up with large uncompressed formats.  Each frame goes to the stripe
+// with the fewest frames waiting, so the receive thread only waits when every
+// stripe is at its limit.
+//
+// Every stripe has an index file (<stripe>.idx) listing the frame number of
+// each frame it holds, one per line.  A text manifest written by flush()
+// ties the stripes together:
+//   size <xres> <yres>
+//   frames <frame count>
+//   stripe <absolute path>
+// ndistripe uses the manifest to reassemble the frames in order.
+struct striped_writer
+{
+	// Constructor and destructor
+	// A path which is a directory gets an ndirx.stripeNN.p216 file inside it
+	striped_writer(FILE *manifest, const std::vector<std::string>& paths, timestamp_log* ts_log, int max_pending=4);
+	~striped_writer(void);
+
+	// Start processing threads
+	void begin(void);
+
+	// Add a captured frame for writing, waits if every stripe is full
+	// Returns false, dropping the frame, if its size differs from the first
+	bool add_frame(std::shared_ptr<NDIlib_video_frame_v2_t> frame);
+
+	// Finish writing all queued frames and write the manifest
+	void flush(void);
+private:
+	// A queued frame
+	struct job
+	{
+		uint64_t index;
+		std::shared_ptr<NDIlib_video_frame_v2_t> frame;
+	};
+
+	// One output file and its write thread
+	struct stripe
+	{
+		std::string path;
+		FILE *outfile;
+		FILE *idxfile;
+		int pending = 0;
+		queue<job> job_q;
+		std::thread thread;
+	};
+
+	// Write frames to one stripe
+	void write_frames(stripe* s);
+
+	// Manifest file
+	FILE *m_manifest;
+
+	// Optional timestamp log
+	timestamp_log* m_ts_log;
+
+	// Frames queued or being written to a stripe before add_frame() waits
+	int m_max_pending;
+
+	// Frame size, from the first frame
+	int m_xres = 0;
+	int m_yres = 0;
+
+	uint64_t m_frames = 0;
+	size_t m_next_stripe = 0;
+
+	std::vector<std::unique_ptr<stripe>> m_stripes;
+
+	// Protects the pending counts, signalled when a frame has been written
+	std::mutex m_lock;
+	std::condition_variable m_condvar;
+};
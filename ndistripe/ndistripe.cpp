@@ -0,0 +1,277 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "ndistripe.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+// Global debug variables, from debug.h
+FILE *dbgstream = stderr;
+int  debug_level = LOG_ERR;
+bool debug_flush = false;
+
+// Reads the frames of one stripe file in order on its own thread, so all the
+// stripes are read in parallel
+struct stripe_reader
+{
+	// Constructor and destructor
+	stripe_reader(const std::string& path, size_t frame_size);
+	~stripe_reader(void);
+
+	// Start processing thread
+	void begin(void);
+
+	// Frame number of the next frame from this stripe, or -1 at the end
+	int64_t next_index(void);
+
+	// Get the next frame from this stripe, NULL once the stripe has ended
+	std::shared_ptr<uint8_t> get_frame(void);
+
+	// Discard any unread frames and wait for the read thread to exit
+	void flush(void);
+private:
+	// Read frames
+	void read_frames(void);
+
+	std::string m_path;
+	FILE *m_infile;
+
+	// Frame numbers in this stripe, from the index file
+	std::vector<uint64_t> m_index;
+	size_t m_next = 0;
+
+	// The read thread has sent its last frame
+	bool m_done = false;
+
+	// Read ahead buffers
+	buffer_pool m_pool;
+
+	// Queue for frames which have been read
+	queue<uint8_t> m_frame_q;
+
+	// The processing thread
+	std::thread m_thread;
+};
+
+stripe_reader::stripe_reader(const std::string& path, size_t frame_size)
+	: m_path(path), m_pool(frame_size, 3)
+{
+	LOG(LOG_INFO, "stripe_reader Constructor\n");
+
+	m_infile = fopen(m_path.c_str(), "rb");
+	if (m_infile == NULL) {
+		LOG(LOG_ERR, "Cannot open %s for reading!\n", m_path.c_str());
+		throw std::runtime_error("Cannot open stripe file!");
+	}
+
+	std::string idx_path = m_path + ".idx";
+	FILE *idxfile = fopen(idx_path.c_str(), "r");
+	if (idxfile == NULL) {
+		LOG(LOG_ERR, "Cannot open %s for reading!\n", idx_path.c_str());
+		throw std::runtime_error("Cannot open stripe index file!");
+	}
+
+	uint64_t index;
+	while (fscanf(idxfile, "%" SCNu64, &index) == 1) {
+		m_index.push_back(index);
+	}
+	fclose(idxfile);
+
+	LOG(LOG_INFO, "%s: %zu frames\n", m_path.c_str(), m_index.size());
+}
+
+stripe_reader::~stripe_reader(void)
+{
+	LOG(LOG_INFO, "stripe_reader Destructor\n");
+
+	fclose(m_infile);
+}
+
+void stripe_reader::begin(void)
+{
+	// Configure the queue to not drop any frames, the buffer pool limits
+	// how far we read ahead
+	m_frame_q.set_depth(0);
+
+	// Start a thread to read frames
+	m_thread = std::thread(&stripe_reader::read_frames, this);
+}
+
+int64_t stripe_reader::next_index(void)
+{
+	return (m_next < m_index.size()) ? (int64_t)m_index[m_next] : -1;
+}
+
+std::shared_ptr<uint8_t> stripe_reader::get_frame(void)
+{
+	if (m_done) return NULL;
+
+	m_next++;
+	std::shared_ptr<uint8_t> frame = m_frame_q.pop();
+	if (!frame) m_done = true;
+
+	return frame;
+}
+
+void stripe_reader::flush(void)
+{
+	while (get_frame());
+	m_thread.join();
+}
+
+void stripe_reader::read_frames(void)
+{
+	pthread_setname_np(pthread_self(), "stripe_read");
+	LOG(LOG_INFO, "stripe_reader thread\n");
+
+	for (size_t i=0; i<m_index.size(); i++) {
+		std::shared_ptr<uint8_t> frame = m_pool.get();
+
+		size_t readsize = fread(frame.get(), 1, m_pool.get_size(), m_infile);
+		if (readsize != m_pool.get_size()) {
+			LOG(LOG_ERR, "%s is shorter than its index!\n", m_path.c_str());
+			break;
+		}
+
+		m_frame_q.push(frame);
+	}
+
+	// An empty frame marks the end of the stripe
+	m_frame_q.push(NULL);
+}
+
+int main(int argc, char* argv[])
+{
+	FILE *outfile = stdout;
+
+	debug_flush = false;
+
+	// Passed on the command line
+	int opt;
+	while ((opt = getopt(argc, argv, "o:vqf")) != -1) {
+		switch (opt) {
+		// Output file
+		case 'o':
+			outfile = fopen(optarg, "wb");
+			if (outfile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
+			break;
+
+		// Debugging
+		case 'v':	// Increase debugging level
+			debug_level++;
+			break;
+		case 'q':	// Decrease debugging level
+			if (debug_level > 0) debug_level--;
+			break;
+		case 'f':	// fflush() debug messages
+			debug_flush = true;
+			break;
+
+		default:	// '?'
+			fprintf(stderr, "Usage: %s [-o <filename>] [-vqf] <manifest>\n", argv[0]);
+			fprintf(stderr, "  Reassemble the frames of a striped recording written by ndirx -S, in order\n");
+			fprintf(stderr, "  -o Specify output filename (default is to use stdout)\n");
+			fprintf(stderr, "  -v Increase debugging output level\n");
+			fprintf(stderr, "  -q Decrease debugging output level\n");
+			fprintf(stderr, "  -f fflush() after each debug message\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (argc - optind != 1) {
+		fprintf(stderr, "Expected a manifest file, try: %s -h\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	FILE *manifest = fopen(argv[optind], "r");
+	if (manifest == NULL) {
+		fprintf (stderr, "Cannot open %s for reading!\n", argv[optind]);
+		exit(EXIT_FAILURE);
+	}
+
+	// Parse the manifest
+	int xres = 0;
+	int yres = 0;
+	uint64_t frames = 0;
+	std::vector<std::string> paths;
+
+	char line[4096];
+	while (fgets(line, sizeof(line), manifest)) {
+		line[strcspn(line, "\n")] = 0;
+
+		if (!strncmp(line, "stripe ", 7)) {
+			paths.push_back(line + 7);
+		} else if (sscanf(line, "size %i %i", &xres, &yres) == 2) {
+		} else if (sscanf(line, "frames %" SCNu64, &frames) == 1) {
+		} else {
+			LOG(LOG_WARN, "Ignoring manifest line: %s\n", line);
+		}
+	}
+	fclose(manifest);
+
+	if ((xres <= 0) || (yres <= 0) || paths.empty()) {
+		LOG(LOG_ERR, "ERROR: Not a valid stripe manifest!\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// P216 frames are a 16-bit Y plane followed by an interleaved 16-bit UV plane
+	size_t frame_size = xres * sizeof(uint16_t) * yres * 2;
+
+	std::vector<stripe_reader*> readers;
+	for (auto& p : paths) {
+		readers.push_back(new stripe_reader(p, frame_size));
+	}
+	for (auto r : readers) r->begin();
+
+	// Missing frames are replaced with black so every later frame stays at
+	// its original position in the output
+	std::vector<uint16_t> black(frame_size / sizeof(uint16_t));
+	std::fill(black.begin(), black.begin() + black.size() / 2, 4096);	// Y
+	std::fill(black.begin() + black.size() / 2, black.end(), 32768);	// UV
+
+	// Each stripe holds its frames in order, so the next frame is always at
+	// the front of one of them
+	uint64_t written = 0;
+	for (uint64_t index=0; index<frames; index++) {
+		stripe_reader *source = NULL;
+		for (auto r : readers) {
+			if (r->next_index() == (int64_t)index) source = r;
+		}
+
+		std::shared_ptr<uint8_t> frame;
+		if (!source) {
+			LOG(LOG_ERR, "Frame %" PRIu64 " is missing, writing black!\n", index);
+		} else {
+			frame = source->get_frame();
+			if (!frame) LOG(LOG_ERR, "Frame %" PRIu64 " could not be read, writing black!\n", index);
+		}
+
+		const uint8_t* data = frame ? frame.get() : (const uint8_t*)black.data();
+		size_t wlen = fwrite(data, 1, frame_size, outfile);
+		if (wlen != frame_size) {
+			throw std::runtime_error("Something went wrong writing the output file!\n");
+		}
+		if (frame) written++;
+	}
+	fflush(outfile);
+
+	if (written != frames) {
+		LOG(LOG_ERR, "Replaced %" PRIu64 " of %" PRIu64 " frames with black!\n", frames - written, frames);
+	}
+	LOG(LOG_INFO, "Wrote %" PRIu64 " of %" PRIu64 " frames\n", written, frames);
+
+	// Let the read threads finish
+	for (auto r : readers) {
+		r->flush();
+		delete r;
+	}
+
+	return (written == frames) ? 0 : 1;
+}
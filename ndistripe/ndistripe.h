@@ -0,0 +1,15 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Debug logging
+#include "../ndi_common/debug.h"
+
+// Thread safe queue
+#include "../ndi_common/queue.h"
+
+// Shared frame buffers
+#include "../ndi_common/buffer_pool.h"
@@ -13,6 +13,13 @@ function ndi2mov () {
 }
 
 function mov2ndi () {
+	if [ -n "${NATIVE}" ] ; then
+		# nditx decodes the clip itself, rate comes from the container
+		echo "nditx -m nditest -L $1 -b ${BITRATE}  -s ${SHQMODE} -c ${COUNT} -w"
+		nditx -m nditest -L $1 -b ${BITRATE}  -s ${SHQMODE} -c ${COUNT} -w
+		return
+	fi
+
 	echo "ffmpeg -i $1 -f image2pipe -vcodec rawvideo -pix_fmt p216le -"
 	echo "nditx -m nditest -r ${RATE_N}/${RATE_D} -b ${BITRATE}  -s ${SHQMODE} -c ${COUNT} -w"
 	ffmpeg -i $1 -f image2pipe -vcodec rawvideo -pix_fmt p216le - | \
@@ -29,10 +36,11 @@ function isInt () {
 
 function usage () {
 	echo "Usage:"
-	echo "$0 [-b bitrate]  [-s SHQ Mode] [-c framecount] [-g generations] -i inputfile -o output_base"
+	echo "$0 [-b bitrate]  [-s SHQ Mode] [-c framecount] [-g generations] [-n] -i inputfile -o output_base"
 	echo "    bitrate : bitrate multiplier percent (default 100)"
 	echo "    framecount : number of frames to transmit (default length of input clip)"
 	echo "    generations : number of generations to process (default 1)"
+	echo "    -n          : nditx decodes the input natively (nditx must be built with LIBAV=1)"
 	echo "    inputfile   : input v210 mov file"
 	echo "    output_base : base name of output files, files will be named: output_base.genNN.mov"
 }
@@ -44,8 +52,9 @@ GENERATION=1
 INPUT=""
 OUTPUT=nditest.v210
 SHQMODE=auto
+NATIVE=""
 
-OPTSTRING="b:c:g:i:o:s:"
+OPTSTRING="b:c:g:i:no:s:"
 
 while getopts ${OPTSTRING} opt; do
 	case ${opt} in
@@ -53,6 +62,7 @@ while getopts ${OPTSTRING} opt; do
 		c) isInt ${OPTARG} ; COUNT=${OPTARG} ;;
 		g) isInt ${OPTARG} ; GENERATION=${OPTARG} ;;
 		i) INPUT=${OPTARG} ;;
+		n) NATIVE=1 ;;
 		o) OUTPUT=${OPTARG} ;;
 		s) SHQMODE=${OPTARG} ;;
 		?) echo "Argument parsing failed"
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "nditx.h"
+
+audio_sender::audio_sender(FILE *infile, const std::vector<sender*>& senders, int rate_n, int rate_d)
+	: m_infile(infile), m_senders(senders), m_rate_n(rate_n), m_rate_d(rate_d), m_stop(false)
+{
+	LOG(LOG_INFO, "audio_sender Constructor\n");
+
+	if (!wav_read_header(m_infile, &m_format)) {
+		throw std::runtime_error("Unsupported audio file, expected 16 or 32-bit PCM or 32-bit float WAV!");
+	}
+
+	LOG(LOG_WARN, "Audio: %i channels @ %i Hz, %i-bit%s\n", m_format.channels,
+		m_format.sample_rate, m_format.bits, m_format.is_float ? " float" : "");
+}
+
+audio_sender::~audio_sender(void)
+{
+	LOG(LOG_INFO, "audio_sender Destructor\n");
+}
+
+void audio_sender::begin(void)
+{
+	// Start a thread to send audio
+	m_thread = std::thread(&audio_sender::send_audio, this);
+}
+
+void audio_sender::flush(void)
+{
+	m_stop = true;
+	m_thread.join();
+}
+
+void audio_sender::send_audio(void)
+{
+	pthread_setname_np(pthread_self(), "audio_send");
+	LOG(LOG_INFO, "audio_sender thread\n");
+
+	int channels = m_format.channels;
+	size_t sample_size = (m_format.bits / 8) * channels;
+
+	// Largest block we will send
+	int max_samples = (int)(((int64_t)m_format.sample_rate * m_rate_d + m_rate_n - 1) / m_rate_n);
+	std::vector<uint8_t> interleaved(max_samples * sample_size);
+	std::vector<float> planar((size_t)max_samples * channels);
+
+	NDIlib_audio_frame_v3_t audio_frame;
+	audio_frame.sample_rate = m_format.sample_rate;
+	audio_frame.no_channels = channels;
+	audio_frame.timecode = NDIlib_send_timecode_synthesize;
+	audio_frame.FourCC = NDIlib_FourCC_audio_type_FLTP;
+	audio_frame.p_data = (uint8_t*) planar.data();
+	audio_frame.channel_stride_in_bytes = max_samples * sizeof(float);
+
+	auto start = std::chrono::steady_clock::now();
+	uint64_t block = 0;
+	uint64_t sent = 0;
+
+	while (!m_stop)
+	{
+		// Block sizes follow the video frame rate exactly, eg: 800 and 801
+		// samples alternating for 48kHz at 60000/1001
+		uint64_t end = (block + 1) * m_format.sample_rate * m_rate_d / m_rate_n;
+		int samples = (int)(end - sent);
+
+		size_t rlen = fread(interleaved.data(), sample_size, samples, m_infile);
+		if (rlen == 0) {
+			LOG(LOG_INFO, "End of audio input\n");
+			break;
+		}
+		samples = (int) rlen;
+
+		interleaved_to_planar(interleaved.data(), m_format, samples, planar.data(), max_samples);
+		audio_frame.no_samples = samples;
+
+		for (auto s : m_senders) s->send_audio(&audio_frame);
+
+		sent += samples;
+		block++;
+
+		// Wait until this block has played out before sending the next one
+		auto deadline = start + std::chrono::nanoseconds(sent * 1000000000ULL / m_format.sample_rate);
+		std::this_thread::sleep_until(deadline);
+	}
+}
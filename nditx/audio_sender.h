@@ -0,0 +1,43 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Reads audio from a WAV file and sends it to every sender on its own
+// thread, independently of the video.  NDI doesn't clock audio for us (only
+// video is clocked) so the thread paces itself against absolute deadlines,
+// one block of samples per video frame period.
+struct audio_sender
+{
+	// Constructor and destructor
+	audio_sender(FILE *infile, const std::vector<sender*>& senders, int rate_n, int rate_d);
+	~audio_sender(void);
+
+	// Start processing thread
+	void begin(void);
+
+	// Stop sending and wait for the thread to exit
+	void flush(void);
+private:
+	// Send audio
+	void send_audio(void);
+
+	// Input file and its format
+	FILE *m_infile;
+	wav_format m_format;
+
+	// Where to send the audio
+	std::vector<sender*> m_senders;
+
+	// Video frame rate, used to size the audio blocks
+	int m_rate_n;
+	int m_rate_d;
+
+	// Set to stop the thread
+	std::atomic<bool> m_stop;
+
+	// The processing thread
+	std::thread m_thread;
+};
@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "nditx.h"
+
+#ifdef HAVE_LIBAV
+
+av_input::av_input(const char* filename)
+{
+	LOG(LOG_INFO, "av_input Constructor\n");
+
+	if (avformat_open_input(&m_format_ctx, filename, NULL, NULL) < 0) {
+		throw std::runtime_error("Cannot open media file!");
+	}
+
+	if (avformat_find_stream_info(m_format_ctx, NULL) < 0) {
+		throw std::runtime_error("Cannot read media stream information!");
+	}
+
+	m_stream = av_find_best_stream(m_format_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+	if (m_stream < 0) throw std::runtime_error("No video stream in media file!");
+
+	AVStream* stream = m_format_ctx->streams[m_stream];
+
+	const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+	if (!codec) throw std::runtime_error("No decoder for video stream!");
+
+	m_codec_ctx = avcodec_alloc_context3(codec);
+	if (!m_codec_ctx) throw std::runtime_error("Cannot allocate decoder!");
+
+	if (avcodec_parameters_to_context(m_codec_ctx, stream->codecpar) < 0) {
+		throw std::runtime_error("Cannot configure decoder!");
+	}
+
+	// Decode several frames in parallel, one per thread
+	m_codec_ctx->thread_count = 0;
+	m_codec_ctx->thread_type = FF_THREAD_FRAME;
+
+	if (avcodec_open2(m_codec_ctx, codec, NULL) < 0) {
+		throw std::runtime_error("Cannot open decoder!");
+	}
+
+	m_rate = av_guess_frame_rate(m_format_ctx, stream, NULL);
+	if ((m_rate.num <= 0) || (m_rate.den <= 0)) {
+		throw std::runtime_error("Cannot determine frame rate of media file!");
+	}
+
+	m_packet = av_packet_alloc();
+	m_frame = av_frame_alloc();
+	if (!m_packet || !m_frame) throw std::runtime_error("Cannot allocate decoder buffers!");
+
+	LOG(LOG_WARN, "Input: %s %ix%i @ %i/%i fps\n", codec->name,
+		get_xres(), get_yres(), get_rate_n(), get_rate_d());
+}
+
+av_input::~av_input(void)
+{
+	LOG(LOG_INFO, "av_input Destructor\n");
+
+	sws_freeContext(m_sws_ctx);
+	av_frame_free(&m_frame);
+	av_packet_free(&m_packet);
+	avcodec_free_context(&m_codec_ctx);
+	avformat_close_input(&m_format_ctx);
+}
+
+float av_input::get_aspect_ratio(void)
+{
+	AVRational sar = av_guess_sample_aspect_ratio(m_format_ctx, m_format_ctx->streams[m_stream], NULL);
+	if ((sar.num <= 0) || (sar.den <= 0)) sar = av_make_q(1, 1);
+
+	return (float)(get_xres() * av_q2d(sar)) / get_yres();
+}
+
+bool av_input::read_frame(uint8_t* buffer)
+{
+	while (true)
+	{
+		// Use a decoded frame if there is one ready
+		int ret = avcodec_receive_frame(m_codec_ctx, m_frame);
+		if (ret == 0) {
+			convert_frame(buffer);
+			av_frame_unref(m_frame);
+			return true;
+		}
+
+		if (ret == AVERROR_EOF) return false;
+		if (ret != AVERROR(EAGAIN)) throw std::runtime_error("Error decoding video!");
+
+		// The decoder needs more input
+		ret = av_read_frame(m_format_ctx, m_packet);
+		if (ret < 0) {
+			// End of file, let the decoder return its remaining frames
+			if (m_draining) return false;
+			m_draining = true;
+			avcodec_send_packet(m_codec_ctx, NULL);
+			continue;
+		}
+
+		if (m_packet->stream_index == m_stream) {
+			if (avcodec_send_packet(m_codec_ctx, m_packet) < 0) {
+				LOG(LOG_WARN, "Skipping corrupt packet\n");
+			}
+		}
+		av_packet_unref(m_packet);
+	}
+}
+
+void av_input::convert_frame(uint8_t* buffer)
+{
+	int xres = get_xres();
+	int yres = get_yres();
+
+	if ((m_frame->width != xres) || (m_frame->height != yres)) {
+		throw std::runtime_error("Unsupported resolution change in media file!");
+	}
+
+	// Reuses the existing context unless the decoded format changes
+	m_sws_ctx = sws_getCachedContext(m_sws_ctx,
+		xres, yres, (AVPixelFormat) m_frame->format,
+		xres, yres, AV_PIX_FMT_P216LE,
+		SWS_BICUBIC, NULL, NULL, NULL);
+	if (!m_sws_ctx) throw std::runtime_error("Cannot convert video to P216!");
+
+	// Write straight into the Y and UV planes of the frame buffer
+	int line_stride = xres * sizeof(uint16_t);
+	uint8_t* dst[4] = { buffer, buffer + (size_t)line_stride * yres, NULL, NULL };
+	int dst_stride[4] = { line_stride, line_stride, 0, 0 };
+
+	sws_scale(m_sws_ctx, m_frame->data, m_frame->linesize, 0, yres, dst, dst_stride);
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#ifdef HAVE_LIBAV
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+// P216 output from swscale needs FFmpeg 5.0 or newer
+#ifndef AV_PIX_FMT_P216
+#error "FFmpeg with P216 support (5.0 or newer) is required for LIBAV=1"
+#endif
+
+// Native media file input using libavformat/libavcodec.  Video is decoded
+// with frame threading and converted to P216 directly into the caller's
+// (pooled) frame buffer, replacing the ffmpeg process and pipe in front of
+// nditx.  Resolution and frame rate come from the container.
+struct av_input
+{
+	// Constructor and destructor
+	av_input(const char* filename);
+	~av_input(void);
+
+	// Video settings from the container
+	int get_xres(void) { return m_codec_ctx->width; }
+	int get_yres(void) { return m_codec_ctx->height; }
+	int get_rate_n(void) { return m_rate.num; }
+	int get_rate_d(void) { return m_rate.den; }
+	float get_aspect_ratio(void);
+
+	// Decode the next frame into a P216 buffer
+	// Returns false at the end of the stream
+	bool read_frame(uint8_t* buffer);
+private:
+	// Convert the decoded frame into a P216 buffer
+	void convert_frame(uint8_t* buffer);
+
+	// Demuxer, decoder, and pixel format converter
+	AVFormatContext* m_format_ctx = NULL;
+	AVCodecContext* m_codec_ctx = NULL;
+	SwsContext* m_sws_ctx = NULL;
+
+	// Reusable packet and frame
+	AVPacket* m_packet = NULL;
+	AVFrame* m_frame = NULL;
+
+	// Index of the video stream we decode
+	int m_stream = -1;
+
+	// Frame rate from the container
+	AVRational m_rate;
+
+	// All packets have been sent to the decoder
+	bool m_draining = false;
+};
+
+#endif
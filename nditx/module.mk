@@ -1,9 +1,17 @@
 local_dir  := $(subdirectory)
 local_pgm  := $(local_dir)/nditx
 local_src  := $(wildcard $(local_dir)/*.cpp)
-local_objs := $(call src_to_obj, $(local_src) $(ndi_common))
+local_objs := $(call src_to_obj, $(local_src)) $(libndiutils)
 
 programs   += $(local_pgm)
 sources    += $(local_src)
 
 $(local_pgm): $(local_objs)
+
+# Optional native media file input (-L), build with: make LIBAV=1
+ifneq ($(LIBAV),)
+local_libav := libavformat libavcodec libavutil libswscale
+
+$(call src_to_obj, $(local_src)): override CXXFLAGS += -DHAVE_LIBAV $(shell $(PKG) --cflags $(local_libav))
+$(local_pgm): override LDLIBS += $(shell $(PKG) --libs $(local_libav))
+endif
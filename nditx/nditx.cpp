@@ -20,36 +20,6 @@ void boilerplate()
 	printf("\n");
 }
 
-void arg2rate(char* arg, int* rate_n, int* rate_d)
-{
-    if(arg)
-    {
-        char* separator = strchr(arg, '/');
-
-        // See if a range specifier was found
-        if (separator == nullptr) {
-            // No range specifier, just convert to an integer rate
-            *rate_n = strtol(arg, nullptr, 0);
-            *rate_d  = 1;
-            return;
-        }
-
-        // Look for first value
-        if (separator == arg) {
-            // No first value, leave unchanged
-        } else {
-            *rate_n = strtol(arg, nullptr, 0);
-        }
-
-        // Look for last value
-        if (separator == (arg + strlen(arg) - 1)) {
-            // No last value, leave unchanged
-        } else {
-            *rate_d = strtol(separator+1, nullptr, 0);
-        }
-    }
-}
-
 int main(int argc, char* argv[])
 {
 	// See if we're running from a terminal and can be interactive
@@ -60,24 +30,33 @@ int main(int argc, char* argv[])
 	// Default options
 	int xres = 1920;
 	int yres = 1080;
-	const char* bitrate = "100";
-	const char* shqmode = "auto";
+	std::vector<std::string> bitrates = { "100" };
+	std::vector<std::string> shqmodes = { "auto" };
 	char* machinename = NULL;
+	const char* transport = NULL;
+	const char* adapters = NULL;
 	char* ndiname = NULL;
 	int rate_n = 6000;
 	int rate_d = 1001;
 	NDIlib_source_t ndi_source;
 	FILE *infile = stdin;
+	const char* infile_name = NULL;
 	bool user_abort = false;
 	bool waitconnect = false;
 	int num_frames = -1;
+	FILE *hashfile = NULL;
+	const char* pattern_name = NULL;
+	const char* media_name = NULL;
+	FILE *audiofile = NULL;
+	FILE *timingfile = NULL;
+	FILE *tracefile = NULL;
 
 	debug_flush = false;
 	int temp;
 
 	// Passed on the command line
 	int opt;
-	while ((opt = getopt(argc, argv, "x:y:r:c:b:s:i:m:n:wvqf")) != -1) {
+	while ((opt = getopt(argc, argv, "x:y:r:c:b:s:i:L:p:a:H:R:j:m:n:t:N:wvqf")) != -1) {
 		switch (opt) {
 		// Resolution
 		case 'x':
@@ -94,6 +73,7 @@ int main(int argc, char* argv[])
 
 		// Input file
 		case 'i':
+			infile_name = optarg;
 			infile = fopen(optarg, "rb");
 			if (infile == NULL) {
 				fprintf (stderr, "Cannot open %s for reading!\n", optarg);
@@ -103,20 +83,70 @@ int main(int argc, char* argv[])
 			user_abort = interactive;
 			break;
 
+		// Media file decoded with libav instead of raw input
+		case 'L':
+			media_name = optarg;
+			// Input is not stdin, enable user abort if we're interactive
+			user_abort = interactive;
+			break;
+
+		// Synthetic test pattern instead of an input file
+		case 'p':
+			pattern_name = optarg;
+			// Input is not stdin, enable user abort if we're interactive
+			user_abort = interactive;
+			break;
+
+		// Audio input file
+		case 'a':
+			audiofile = fopen(optarg, "rb");
+			if (audiofile == NULL) {
+				fprintf (stderr, "Cannot open %s for reading!\n", optarg);
+				abort();
+			}
+			break;
+
+		// Hash log file
+		case 'H':
+			hashfile = fopen(optarg, "w");
+			if (hashfile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
+			break;
+
 		// Frame count
 		case 'c':
 			temp = strtol(optarg, NULL, 0);
 			if (temp > 0) num_frames = temp;
 			break;
 
-		// Bitrate
+		// Bitrate(s)
 		case 'b':
-			bitrate = optarg;
+			bitrates = split_list(optarg);
 			break;
 
-		// SHQ Mode
+		// SHQ Mode(s)
 		case 's':
-			shqmode = optarg;
+			shqmodes = split_list(optarg);
+			break;
+
+		// Replay timing sidecar
+		case 'R':
+			timingfile = fopen(optarg, "rb");
+			if (timingfile == NULL) {
+				fprintf (stderr, "Cannot open %s for reading!\n", optarg);
+				abort();
+			}
+			break;
+
+		// Trace file
+		case 'j':
+			tracefile = fopen(optarg, "w");
+			if (tracefile == NULL) {
+				fprintf (stderr, "Cannot open %s for writing!\n", optarg);
+				abort();
+			}
 			break;
 
 		// NDI source name
@@ -129,6 +159,16 @@ int main(int argc, char* argv[])
 			machinename = optarg;
 			break;
 
+		// Transport
+		case 't':
+			transport = optarg;
+			break;
+
+		// Network adapters
+		case 'N':
+			adapters = optarg;
+			break;
+
 		// Wait for connection to start streaming
 		case 'w':
 			waitconnect = true;
@@ -147,16 +187,28 @@ int main(int argc, char* argv[])
 
 		default:	// '?'
 			fprintf(stderr, "Usage:\n");
-			fprintf(stderr, "%s [-x XRes] [-y Yres] [-r framerate-n[/framerate_d]] [-c frame-count] [-b bitrate] [-s SHQ-mode] [-i infile] [-m <machine name>] [-n <NDI name>] [-wvqf]\n", argv[0]);
+			fprintf(stderr, "%s [-x XRes] [-y Yres] [-r framerate-n[/framerate_d]] [-c frame-count] [-b bitrate] [-s SHQ-mode] [-i infile | -L mediafile | -p pattern] [-a audio.wav] [-H hashlog] [-R timing file] [-j trace file] [-m <machine name>] [-n <NDI name>] [-t transport] [-N adapter[,adapter...]] [-wvqf]\n", argv[0]);
 			fprintf(stderr, "  -x Horizontal resolution (default: 1920)\n");
 			fprintf(stderr, "  -y Vertical resolution (default: 1080)\n");
 			fprintf(stderr, "  -r Frame rate (default: 6000/1001)\n");
 			fprintf(stderr, "  -c Frame count or number of frames to send (default: send until EOF)\n");
-			fprintf(stderr, "  -b Bit-rate multiplier (default: 100)\n");
-			fprintf(stderr, "  -s SpeedHQ mode: 4:2:0, 4:2:2, or auto (default: auto)\n");
+			fprintf(stderr, "  -b Bit-rate multiplier, or comma separated list (default: 100)\n");
+			fprintf(stderr, "  -s SpeedHQ mode: 4:2:0, 4:2:2, or auto, or comma separated list (default: auto)\n");
 			fprintf(stderr, "  -i Input filename (default: stdin)\n");
+#ifdef HAVE_LIBAV
+			fprintf(stderr, "  -L Decode the specified media file directly, resolution and rate come from the file\n");
+#else
+			fprintf(stderr, "  -L Decode the specified media file directly (requires building with LIBAV=1)\n");
+#endif
+			fprintf(stderr, "  -p Send a generated test pattern instead of reading input: %s\n", pattern::names());
+			fprintf(stderr, "  -a Also send audio from a 16 or 32-bit PCM or 32-bit float WAV file\n");
+			fprintf(stderr, "  -H Write a hash of each input frame to the specified file\n");
+			fprintf(stderr, "  -R Send frames with the cadence recorded by ndirx -T instead of the fixed frame rate\n");
+			fprintf(stderr, "  -j Write a Chrome trace of per-frame events at exit or on SIGUSR1 (open with Perfetto)\n");
 			fprintf(stderr, "  -m NDI machine name (default: hostname)\n");
 			fprintf(stderr, "  -n NDI stream name (default: %s)\n", argv[0]);
+			fprintf(stderr, "  -t Only send using this transport: %s (default: any)\n", transport_names());
+			fprintf(stderr, "  -N Only use the network adapters with these IP addresses\n");
 			fprintf(stderr, "  -w Wait for receiver to connect before sending frames and disconnect before exiting (use with -c)\n");
 			fprintf(stderr, "  -v Increase debugging output level\n");
 			fprintf(stderr, "  -q Decrease debugging output level\n");
@@ -168,53 +220,117 @@ int main(int argc, char* argv[])
 	// It's safe to send some info to stdout
 	boilerplate();
 
-	// Setup the NDI sender
+	// Check for conflicting options
+	if (bitrates.empty() || shqmodes.empty()) {
+		LOG(LOG_ERR, "ERROR: No bit-rate or SpeedHQ mode specified!\n");
+		exit(EXIT_FAILURE);
+	}
+	if (transport && !is_transport(transport)) {
+		LOG(LOG_ERR, "ERROR: Unknown transport %s, try: %s\n", transport, transport_names());
+		exit(EXIT_FAILURE);
+	}
+	if ((!!infile_name + !!media_name + !!pattern_name) > 1) {
+		LOG(LOG_ERR, "ERROR: Only one of an input file, media file, or test pattern can be used!\n");
+		exit(EXIT_FAILURE);
+	}
+#ifndef HAVE_LIBAV
+	if (media_name) {
+		LOG(LOG_ERR, "ERROR: Built without libav support, rebuild with LIBAV=1 to use -L!\n");
+		exit(EXIT_FAILURE);
+	}
+#endif
+
+	// Setup the NDI senders
 	////////////////////////////////////////////////////////////
 
 	// Not required, but "correct" (see the SDK documentation.
 	if (!NDIlib_initialize()) throw std::runtime_error("Cannot run NDI!");
 
-	// Configure our sender settings
-	NDIlib_send_create_t my_settings;
-	my_settings.p_ndi_name = ndiname;
-	my_settings.p_groups = nullptr;
-	my_settings.clock_video = true;
-	my_settings.clock_audio = false;
-
-	// Create a JSON configuration string we can pass to the NDI library
-	// These configuration settings can also be done using a file
-	// See "Configuration Files" in the SDK documentation for details
-
-	// Opening stanza
-	std::string ndi_config;
-	ndi_config = R"({ "ndi": {)";
-
-	// Without a valid vendor ID, the Embedded NDI stack runs in demo mode for 30 minutes
-	// If you have a valid vendor ID, add it below, eg:
-	// ndi_config.append( R"( "vendor": { "name": "My Company", "id": "00000000000000000000000000000000000000000000", } )";
-
-	// If machinename is specified, add it to our JSON config
-	if (machinename) {
-		ndi_config.append( R"( "machinename": ")" );
-		ndi_config.append( machinename );
-		ndi_config.append( R"(", )" );
+	// Read the replay schedule
+	std::shared_ptr<std::vector<timing_record>> schedule;
+	if (timingfile) {
+		schedule = std::make_shared<std::vector<timing_record>>();
+		if (!timing_read(timingfile, *schedule)) {
+			LOG(LOG_ERR, "ERROR: Not a valid timing file!\n");
+			exit(EXIT_FAILURE);
+		}
+		fclose(timingfile);
+
+		// Stop at the end of the schedule
+		if ((num_frames < 0) || ((size_t)num_frames > schedule->size())) {
+			num_frames = schedule->size();
+		}
+		LOG(LOG_WARN, "Replaying timing of %zu frames\n", schedule->size());
 	}
 
-	// Specify codec settings
-	ndi_config.append( R"( "codec": { "shq": { "quality": )" );
-	ndi_config.append( bitrate );
-	ndi_config.append( R"(, "mode": ")" );
-	ndi_config.append( shqmode );
-	ndi_config.append( R"(" } } )" );
+	// Open the media file, which determines our video settings
+	float aspect_ratio = 16.0/9.0;
+#ifdef HAVE_LIBAV
+	av_input *my_input = NULL;
+	if (media_name) {
+		my_input = new av_input(media_name);
+		xres = my_input->get_xres();
+		yres = my_input->get_yres();
+		rate_n = my_input->get_rate_n();
+		rate_d = my_input->get_rate_d();
+		aspect_ratio = my_input->get_aspect_ratio();
+	}
+#endif
 
-	// Closing braces
-	ndi_config.append( R"(} })" );
+	// Calculate expected line stride and frame size
+	int line_stride =  xres * sizeof(uint16_t);
+	size_t frame_size = line_stride * yres * 2;
 
-	LOG(LOG_INFO, "ndi_config: %s\n",  ndi_config.c_str());
+	// Initialize our frame structure with the video settings
+	NDIlib_video_frame_v2_t video_format;
+	video_format.xres = xres;
+	video_format.yres = yres;
+	video_format.FourCC = NDIlib_FourCC_video_type_P216;
+	video_format.frame_rate_N = rate_n;
+	video_format.frame_rate_D = rate_d;
+	video_format.picture_aspect_ratio = aspect_ratio;
+	video_format.frame_format_type = NDIlib_frame_format_type_progressive;
+	video_format.timecode = NDIlib_send_timecode_synthesize;
+	video_format.p_data = NULL;
+	video_format.line_stride_in_bytes = line_stride;
+	video_format.p_metadata = NULL;
+
+	// Create one sender for every combination of bitrate and SpeedHQ mode
+	// so a single pass over the input produces the whole test matrix
+	std::vector<std::string> sender_names;
+	std::vector<sender*> senders;
+	bool fan_out = (bitrates.size() * shqmodes.size()) > 1;
+
+	for (auto& bitrate : bitrates) {
+		for (auto& shqmode : shqmodes) {
+			// Each sender needs a unique name when sending more than one stream
+			std::string name = ndiname ? ndiname : "";
+			if (fan_out) {
+				if (name.empty()) name = "nditx";
+				name += " b" + bitrate + " " + shqmode;
+			}
+			sender_names.push_back(name);
 
-	// Create an NDI sender
-	NDIlib_send_instance_t ndi_send = NDIlib_send_create_v2(&my_settings, ndi_config.c_str());
-	if (!ndi_send) throw std::runtime_error("Cannot create NDI Sender!");
+			std::string ndi_config = make_send_config(machinename, bitrate, shqmode, transport, adapters);
+			// When replaying we do the clocking ourselves
+			senders.push_back(new sender(name.empty() ? NULL : name.c_str(), ndi_config, video_format, !schedule));
+		}
+	}
+
+	// Input frames are read once into shared buffers which are handed to
+	// every sender.  A buffer is returned to the pool when all senders are
+	// done with it.  Allow for two frames in flight per sender (the one
+	// being sent and the one the NDI library is still compressing), plus
+	// one per hash thread when hashing, plus two more so reading can run
+	// ahead.
+	const int hash_threads = 4;
+	buffer_pool pool(frame_size, 2 * senders.size() + (hashfile ? hash_threads : 0) + 2);
+
+	// Generated test pattern
+	pattern *my_pattern = NULL;
+	if (pattern_name) {
+		my_pattern = new pattern(pattern_name, xres, yres);
+	}
 
 	// Setup to poll stdin to see if read data is available
 	pollfd fds[1];
@@ -222,45 +338,46 @@ int main(int argc, char* argv[])
 	fds[0].events = POLLIN;
 	fds[0].revents = 0;
 
-	// We need two NDI frames so we can use asynchronous sending and allow
-	// the NDI library to do video compression on a different thread than
-	// our thread which is reading the video data
-	NDIlib_video_frame_v2_t video_frame[2];
+	// Wait until a receiver connects to each sender
+	if (waitconnect) {
+		LOG(LOG_ERR, "Waiting for connection with a receiver. Ctrl+C to cancel.\n");
+		for (size_t i=0; i<senders.size(); i++) {
+			LOG(LOG_INFO, "Waiting for %s\n", sender_names[i].c_str());
+			int nConnections;
+			do {
+				nConnections = senders[i]->get_no_connections(1000);
+			} while (nConnections == 0);
+		}
+	}
 
-	// Calculate expected line stride and frame size
-	int line_stride =  xres * sizeof(uint16_t);
-	size_t frame_size = line_stride * yres * 2;
+	// All senders replay against the same start time, leaving a little time
+	// to read ahead before the first frame is due
+	if (schedule) {
+		uint64_t start_ns = monotonic_ns() + 100000000ULL;
+		for (auto s : senders) s->set_schedule(schedule, start_ns);
+	}
+
+	// Start tracing before any of our threads start
+	if (tracefile) trace_begin(tracefile);
 
-	// Initialize our frame structures with the video settings
-	video_frame[0].xres = xres;
-	video_frame[0].yres = yres;
-	video_frame[0].FourCC = NDIlib_FourCC_video_type_P216;
-	video_frame[0].frame_rate_N = rate_n;
-	video_frame[0].frame_rate_D = rate_d;
-	video_frame[0].picture_aspect_ratio = 16.0/9.0;
-	video_frame[0].frame_format_type = NDIlib_frame_format_type_progressive;
-	video_frame[0].timecode = NDIlib_send_timecode_synthesize;
-	video_frame[0].p_data = NULL;
-	video_frame[0].line_stride_in_bytes = line_stride;
-	video_frame[0].p_metadata = NULL;
-	video_frame[1] = video_frame[0];
-
-	// Allocate our video buffers
-	for (int i=0; i<2; i++) {
-		video_frame[i].p_data = (uint8_t*) malloc(frame_size);
-		if (!video_frame[i].p_data) throw std::runtime_error("Cannot allocate video buffer!");
+	// Start the send threads
+	for (auto s : senders) s->begin();
+
+	// Audio is read and sent on its own thread
+	audio_sender *my_audio = NULL;
+	if (audiofile) {
+		my_audio = new audio_sender(audiofile, senders, rate_n, rate_d);
+		my_audio->begin();
 	}
 
-	// Wait until a receiver connects
-	if (waitconnect) {
-		int nConnections;
-		LOG(LOG_ERR, "Waiting for connection with a receiver. Ctrl+C to cancel.\n");
-		do {
-			nConnections = NDIlib_send_get_no_connections(ndi_send, 1000);
-		} while (nConnections == 0);
+	// Hash input frames on separate threads so sending is never held up
+	hasher *my_hasher = NULL;
+	if (hashfile) {
+		my_hasher = new hasher(hashfile, hash_threads);
+		my_hasher->begin();
 	}
 
-	int j = 0;
+	uint64_t frame_count = 0;
 	while (num_frames != 0)
 	{
 		// Check for user abort (data available on stdin)
@@ -268,37 +385,83 @@ int main(int argc, char* argv[])
 			break;
 		}
 
-		// Read a frame from the input file
-		size_t readsize = fread(video_frame[j & 0x01].p_data, 1, frame_size, infile);
-		if (readsize != frame_size) {
-			LOG(LOG_ERR, "Unable to read from input!\n");
-			break;
+		// Write the trace if requested
+		trace_poll();
+
+		// Get a free buffer, waiting for the slowest sender if needed
+		std::shared_ptr<uint8_t> frame = pool.get();
+
+		{
+			trace_span span("read", frame_count);
+			if (my_pattern) {
+				// Generate the next test pattern frame
+				my_pattern->render(frame.get(), frame_count);
+#ifdef HAVE_LIBAV
+			} else if (my_input) {
+				// Decode the next frame straight into the buffer
+				if (!my_input->read_frame(frame.get())) {
+					LOG(LOG_ERR, "End of media file!\n");
+					break;
+				}
+#endif
+			} else {
+				// Read a frame from the input file
+				size_t readsize = fread(frame.get(), 1, frame_size, infile);
+				if (readsize != frame_size) {
+					LOG(LOG_ERR, "Unable to read from input!\n");
+					break;
+				}
+			}
 		}
 
-		// Send the frame to our NDI sender
-		NDIlib_send_send_video_v2(ndi_send, &video_frame[j & 0x01]);
+		// Hash the input frame
+		if (my_hasher) my_hasher->add_frame(frame, frame.get(), frame_size);
 
-		j++;
+		// Send the frame to all of our NDI senders
+		for (auto s : senders) s->add_frame(frame);
+
+		frame_count++;
 		if (num_frames > 0) num_frames--;
 	}
 
 	// Make sure NDI has sent our last frame
-	NDIlib_send_send_video_v2(ndi_send, NULL);
+	for (auto s : senders) s->flush();
 
-	// Release our video buffers
-	for (int i=0; i<2; i++) {
-		if (video_frame[i].p_data) free(video_frame[i].p_data);
+	// Stop sending audio
+	if (my_audio) {
+		my_audio->flush();
+		delete my_audio;
+		fclose(audiofile);
 	}
 
-	// Wait until the receiver disconnects
-	int nConnections;
+	if (my_pattern) delete my_pattern;
+#ifdef HAVE_LIBAV
+	if (my_input) delete my_input;
+#endif
+
+	// Wait for all the hashes to be logged
+	if (my_hasher) {
+		my_hasher->flush();
+		delete my_hasher;
+		fclose(hashfile);
+	}
+
+	if (tracefile) {
+		trace_end();
+		fclose(tracefile);
+	}
+
+	// Wait until the receivers disconnect
 	LOG(LOG_ERR, "Waiting for connection to end. Ctrl+C to cancel.\n");
-	do {
-		nConnections = NDIlib_send_get_no_connections(ndi_send, 1000);
-	} while (nConnections > 0);
+	for (auto s : senders) {
+		int nConnections;
+		do {
+			nConnections = s->get_no_connections(1000);
+		} while (nConnections > 0);
+	}
 
-	// Destroy the sender
-	NDIlib_send_destroy(ndi_send);
+	// Destroy the senders
+	for (auto s : senders) delete s;
 
 	// Not required, but nice
 	NDIlib_destroy();
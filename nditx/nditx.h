@@ -5,9 +5,18 @@
 
 #pragma once
 
-// Debug logging
-#include "../ndi_common/debug.h"
+// NDI sending and shared utilities
+#include "../libndiutils/ndiutils.h"
 
-// NDI library
-#include <Processing.NDI.Lib.h>
-#include <Processing.NDI.Advanced.h>
+// Frame hashing
+#include "../ndi_common/hash.h"
+
+// Synthetic test patterns
+#include "pattern.h"
+
+// Native media file input
+#include "avinput.h"
+
+// Audio input
+#include "../ndi_common/audio.h"
+#include "audio_sender.h"
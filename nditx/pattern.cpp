@@ -0,0 +1,265 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "../ndi_common/stdafx.h"
+#include "nditx.h"
+
+#include <cmath>
+
+// P216 holds 10-bit video levels in the upper bits of each 16-bit sample
+#define P216_LEVEL(x)   ((uint16_t)((x) << 6))
+#define Y_BLACK         P216_LEVEL(64)
+#define Y_WHITE         P216_LEVEL(940)
+#define C_NEUTRAL       P216_LEVEL(512)
+
+// Number of frames for the zone plate to move one full cycle
+#define ZONE_PERIOD     (32)
+
+// Extra noise samples, each frame starts at a different offset into these
+#define NOISE_EXTRA     (64 * 1024)
+
+// 5x7 font for the frame counter, one byte per row, MSB on the left
+static const uint8_t digit_font[10][7] = {
+	{ 0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70 },	// 0
+	{ 0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70 },	// 1
+	{ 0x70, 0x88, 0x08, 0x10, 0x20, 0x40, 0xF8 },	// 2
+	{ 0xF8, 0x10, 0x20, 0x10, 0x08, 0x88, 0x70 },	// 3
+	{ 0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10 },	// 4
+	{ 0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70 },	// 5
+	{ 0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70 },	// 6
+	{ 0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40 },	// 7
+	{ 0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70 },	// 8
+	{ 0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60 },	// 9
+};
+#define COUNTER_DIGITS  (8)
+
+// Zone plate phase for one axis of a frame, the frequency increases linearly
+// away from the centre and reaches Nyquist at the left and right edges
+static double zone_phase(int pos, int size, int xres)
+{
+	double delta = pos - size / 2.0;
+	return M_PI * delta * delta / xres;
+}
+
+pattern::pattern(const char* name, int xres, int yres)
+	: m_xres(xres), m_yres(yres)
+{
+	LOG(LOG_INFO, "pattern Constructor\n");
+
+	if ((xres <= 0) || (yres <= 0) || (xres & 1)) {
+		throw std::runtime_error("Test patterns need a positive, even horizontal resolution!");
+	}
+
+	if (!strcmp(name, "bars")) {
+		m_type = bars;
+	} else if (!strcmp(name, "zoneplate")) {
+		m_type = zoneplate;
+	} else if (!strcmp(name, "noise")) {
+		m_type = noise;
+	} else if (!strcmp(name, "counter")) {
+		m_type = counter;
+	} else {
+		throw std::runtime_error("Unknown test pattern!");
+	}
+
+	size_t pixels = (size_t)xres * yres;
+
+	if (m_type == zoneplate) {
+		// Circular zone plate whose frequency reaches Nyquist at the left and
+		// right edges.  The phase k*(dx^2 + dy^2) separates into a column and
+		// a row term, so only cos and sin of the column term are stored and
+		// each line is a rotation of those: cos(a+b) = cos(a)cos(b) - sin(a)sin(b)
+		m_zone_cos.resize(xres);
+		m_zone_sin.resize(xres);
+
+		for (int x=0; x<xres; x++) {
+			double phase = zone_phase(x, xres, xres);
+			m_zone_cos[x] = (int16_t) lrint(cos(phase) * 32767.0);
+			m_zone_sin[x] = (int16_t) lrint(sin(phase) * 32767.0);
+		}
+	}
+
+	if (m_type == noise) {
+		// Uniform luma noise across the legal range (xorshift64*)
+		m_noise.resize(pixels + NOISE_EXTRA);
+
+		uint64_t state = 0x2545F4914F6CDD1DULL;
+		for (auto& sample : m_noise) {
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			uint64_t r = (state * 0x2545F4914F6CDD1DULL) >> 32;
+			sample = Y_BLACK + (uint16_t)((r * (Y_WHITE - Y_BLACK + 1)) >> 32);
+		}
+	}
+}
+
+pattern::~pattern(void)
+{
+	LOG(LOG_INFO, "pattern Destructor\n");
+}
+
+const char* pattern::names(void)
+{
+	return "bars, zoneplate, noise, or counter";
+}
+
+void pattern::render(uint8_t* buffer, uint64_t frame)
+{
+	// Is this the first time we've seen this buffer?
+	bool first = m_ready.insert(buffer).second;
+
+	switch (m_type) {
+	case bars:
+		if (first) render_bars(buffer);
+		break;
+
+	case zoneplate:
+		if (first) fill_neutral_chroma(buffer);
+		render_zoneplate(buffer, frame);
+		break;
+
+	case noise:
+		if (first) fill_neutral_chroma(buffer);
+		render_noise(buffer, frame);
+		break;
+
+	case counter:
+		if (first) render_bars(buffer);
+		render_counter(buffer, frame);
+		break;
+	}
+}
+
+void pattern::render_bars(uint8_t* buffer)
+{
+	// 75% bars: white, yellow, cyan, green, magenta, red, blue
+	static const int rgb[7][3] = {
+		{ 1, 1, 1 }, { 1, 1, 0 }, { 0, 1, 1 }, { 0, 1, 0 },
+		{ 1, 0, 1 }, { 1, 0, 0 }, { 0, 0, 1 },
+	};
+
+	// Build one line of each plane using BT.709 video levels...
+	std::vector<uint16_t> y_line(m_xres);
+	std::vector<uint16_t> uv_line(m_xres);
+
+	for (int x=0; x<m_xres; x++) {
+		int bar = x * 7 / m_xres;
+		double r = 0.75 * rgb[bar][0];
+		double g = 0.75 * rgb[bar][1];
+		double b = 0.75 * rgb[bar][2];
+
+		double luma = 0.2126 * r + 0.7152 * g + 0.0722 * b;
+		y_line[x] = P216_LEVEL(lrint(64 + 876 * luma));
+
+		// Chroma is co-sited with the even luma samples
+		if ((x & 1) == 0) {
+			uv_line[x]     = P216_LEVEL(lrint(512 + 896 * (b - luma) / 1.8556));
+			uv_line[x + 1] = P216_LEVEL(lrint(512 + 896 * (r - luma) / 1.5748));
+		}
+	}
+
+	// ...then replicate it down the frame
+	uint16_t* y_plane = (uint16_t*) buffer;
+	uint16_t* uv_plane = y_plane + (size_t)m_xres * m_yres;
+	size_t line_size = m_xres * sizeof(uint16_t);
+
+	for (int y=0; y<m_yres; y++) {
+		memcpy(y_plane + (size_t)y * m_xres, y_line.data(), line_size);
+		memcpy(uv_plane + (size_t)y * m_xres, uv_line.data(), line_size);
+	}
+}
+
+void pattern::render_zoneplate(uint8_t* buffer, uint64_t frame)
+{
+	// Move the rings a little each frame
+	double t = 2.0 * M_PI * (frame % ZONE_PERIOD) / ZONE_PERIOD;
+
+	const int32_t mid = (Y_WHITE + Y_BLACK) / 2;
+	const int32_t amp = (Y_WHITE - Y_BLACK) / 2;
+
+	uint16_t* y_plane = (uint16_t*) buffer;
+	const int16_t* zc = m_zone_cos.data();
+	const int16_t* zs = m_zone_sin.data();
+
+	for (int y=0; y<m_yres; y++) {
+		// Row term of the phase, with the amplitude folded in so the loop
+		// below only needs 16x16 bit multiplies
+		double phase = zone_phase(y, m_yres, m_xres) + t;
+		const int16_t cb = (int16_t) lrint(cos(phase) * amp);
+		const int16_t sb = (int16_t) lrint(sin(phase) * amp);
+
+		// Plain integer loop so the compiler vectorizes it
+		uint16_t* y_line = y_plane + (size_t)y * m_xres;
+		for (int x=0; x<m_xres; x++) {
+			int32_t v = ((int32_t)zc[x] * cb - (int32_t)zs[x] * sb) >> 15;
+			y_line[x] = (uint16_t)(mid + v);
+		}
+	}
+}
+
+void pattern::render_noise(uint8_t* buffer, uint64_t frame)
+{
+	// A different window of the noise each frame, SpeedHQ is intra-only so
+	// this costs the encoder the same as fresh noise
+	size_t offset = (frame * 7919) % NOISE_EXTRA;
+	size_t pixels = (size_t)m_xres * m_yres;
+
+	memcpy(buffer, m_noise.data() + offset, pixels * sizeof(uint16_t));
+}
+
+void pattern::render_counter(uint8_t* buffer, uint64_t frame)
+{
+	// Size of one font dot, kept even so the box lines up with the chroma
+	int dot = std::max(2, (m_yres / 120) & ~1);
+
+	// Black box with a one dot border around the digits
+	int box_x = dot * 4;
+	int box_y = dot * 4;
+	int box_w = std::min(dot * (COUNTER_DIGITS * 6 + 1), m_xres - box_x);
+	int box_h = std::min(dot * 9, m_yres - box_y);
+	if ((box_w <= 0) || (box_h <= 0)) return;
+
+	uint16_t* y_plane = (uint16_t*) buffer;
+	uint16_t* uv_plane = y_plane + (size_t)m_xres * m_yres;
+
+	for (int y=box_y; y<box_y + box_h; y++) {
+		uint16_t* y_line = y_plane + (size_t)y * m_xres;
+		uint16_t* uv_line = uv_plane + (size_t)y * m_xres;
+		for (int x=box_x; x<box_x + box_w; x++) {
+			y_line[x] = Y_BLACK;
+			uv_line[x] = C_NEUTRAL;
+		}
+	}
+
+	// Draw the digits, most significant first
+	uint64_t value = frame;
+	for (int d=COUNTER_DIGITS - 1; d>=0; d--) {
+		const uint8_t* glyph = digit_font[value % 10];
+		value /= 10;
+
+		for (int row=0; row<7; row++) {
+			for (int col=0; col<5; col++) {
+				if (!(glyph[row] & (0x80 >> col))) continue;
+
+				int x0 = box_x + dot * (1 + d * 6 + col);
+				int y0 = box_y + dot * (1 + row);
+				for (int y=y0; y<std::min(y0 + dot, m_yres); y++) {
+					for (int x=x0; x<std::min(x0 + dot, m_xres); x++) {
+						y_plane[(size_t)y * m_xres + x] = Y_WHITE;
+					}
+				}
+			}
+		}
+	}
+}
+
+void pattern::fill_neutral_chroma(uint8_t* buffer)
+{
+	size_t pixels = (size_t)m_xres * m_yres;
+	uint16_t* uv_plane = (uint16_t*) buffer + pixels;
+
+	std::fill(uv_plane, uv_plane + pixels, C_NEUTRAL);
+}
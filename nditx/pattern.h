@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Vizrt NDI AB
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Synthetic P216 test pattern source, so the NDI encoder can be loaded
+// without any input I/O.  Frames are rendered straight into the caller's
+// (pooled) buffers.  Anything that does not change between frames is only
+// rendered the first time a buffer is seen, so static patterns cost nothing
+// per frame once every pool buffer has been used.
+struct pattern
+{
+	// Constructor and destructor
+	// Throws if the pattern name is unknown
+	pattern(const char* name, int xres, int yres);
+	~pattern(void);
+
+	// Render the given frame number into a P216 buffer
+	void render(uint8_t* buffer, uint64_t frame);
+
+	// List of valid pattern names, for usage messages
+	static const char* names(void);
+private:
+	enum type_e { bars, zoneplate, noise, counter };
+
+	// Fill both planes with 75% colour bars
+	void render_bars(uint8_t* buffer);
+
+	// Fill the luma plane with a zone plate moved along by frame
+	void render_zoneplate(uint8_t* buffer, uint64_t frame);
+
+	// Fill the luma plane with a window of the precomputed noise
+	void render_noise(uint8_t* buffer, uint64_t frame);
+
+	// Burn the frame number into the top left corner
+	void render_counter(uint8_t* buffer, uint64_t frame);
+
+	// Set both chroma components of the whole frame to neutral
+	void fill_neutral_chroma(uint8_t* buffer);
+
+	type_e m_type;
+	int m_xres;
+	int m_yres;
+
+	// Buffers which already hold the static parts of the pattern
+	std::set<uint8_t*> m_ready;
+
+	// Zone plate cosine and sine of the column phase (Q15)
+	std::vector<int16_t> m_zone_cos;
+	std::vector<int16_t> m_zone_sin;
+
+	// Noise luma, a little larger than one plane so each frame can use a
+	// different window of it
+	std::vector<uint16_t> m_noise;
+};